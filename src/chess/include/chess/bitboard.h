@@ -476,7 +476,17 @@ constexpr Bitboard Bitboard::ray(Bitboard to) const {
   else return Bitboard::backward_slash_diagonal[fx + fy];              // On diagonal (backward slash /) ray.
 }
 
-constexpr int Bitboard::count() const { return __builtin_popcountll(value); }
+constexpr int Bitboard::count() const {
+#if defined(__x86_64__) && !defined(__POPCNT__)
+  // Without the POPCNT instruction, __builtin_popcountll is a call into libgcc, which is slower than counting inline.
+  uint64_t x{value - ((value >> 1) & 0x5555555555555555)};
+  x = (x & 0x3333333333333333) + ((x >> 2) & 0x3333333333333333);
+  x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0f;
+  return static_cast<int>((x * 0x0101010101010101) >> 56);
+#else
+  return __builtin_popcountll(value);
+#endif
+}
 
 constexpr std::string Bitboard::to_string() const {
   std::string s;
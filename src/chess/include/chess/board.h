@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <cassert>
 #include <concepts>
 #include <optional>
 #include <string_view>
@@ -8,9 +10,12 @@
 #include "bitboard.h"
 #include "move_container.h"
 #include "player.h"
+#include "zobrist.h"
 
 namespace chess {
 
+class BoardInfo;
+
 // clang-format off
 template <typename T>
 concept IsRepetitionTracker = requires(T repetition_tracker) {
@@ -26,16 +31,38 @@ public:
   // Starting board of a chess game.
   static constexpr Board initial();
 
-  // Construct a board from FEN.
+  // Construct a board from FEN. The halfmove clock and fullmove counter may be omitted.
   // https://www.chessprogramming.org/Forsyth-Edwards_Notation
+  // Throws a `std::invalid_argument` if the FEN is invalid.
   static Board from_fen(std::string_view fen);
 
+  // Same as `from_fen`, but returns std::nullopt if the FEN is invalid (and sets `error` to the reason, if given).
+  // This does not allocate, so it is suitable for loading many positions.
+  static std::optional<Board> try_from_fen(std::string_view fen, std::string_view *error = nullptr);
+
   // Returns a new board that is the result of applying the given move.
   constexpr Board apply_move(const Move &move) const;
 
+  // The state that cannot be recovered from a move when unmaking it. The captured piece is not stored, as it is
+  // part of the move itself.
+  struct UndoInfo {
+    uint64_t hash;
+    Bitboard en_passant_bit;
+    int16_t halfmove_clock;
+    bool white_can_castle_kingside;
+    bool white_can_castle_queenside;
+    bool black_can_castle_kingside;
+    bool black_can_castle_queenside;
+  };
+
+  // Applies the given move to this board in place. Returns the information needed by `unmake_move` to undo it.
+  constexpr UndoInfo make_move(const Move &move);
+
+  // Undoes the given move, which must be the last move made by `make_move` (which returned `undo_info`).
+  constexpr void unmake_move(const Move &move, const UndoInfo &undo_info);
+
   // Returns a reference to the current player whose turn it is.
   constexpr const Player &cur_player() const;
-  constexpr Player &cur_player();
 
   // Generate a list of all legal captures and promotions.
   MoveContainer generate_quiescence_moves() const;
@@ -46,6 +73,9 @@ public:
   // Generate a list of all legal moves.
   MoveContainer generate_moves() const;
 
+  // Returns the number of legal moves. This is faster than generating them.
+  size_t count_moves() const;
+
   // Returns true if the current player still has any move to make.
   bool has_moves() const;
 
@@ -58,12 +88,22 @@ public:
   // Check if the given square is under attack by the opponent.
   bool is_under_attack(Bitboard square) const;
 
+  // Returns the pieces (of both players) among `occupied` that attack `square`, where `occupied` are the squares
+  // treated as occupied. Removing pieces from `occupied` reveals the sliders behind them (x-rays).
+  // `square` must have exactly one bit set, otherwise it is undefined behavior.
+  Bitboard attackers_to(Bitboard square, Bitboard occupied) const;
+
+  // Static exchange evaluation (https://www.chessprogramming.org/Static_Exchange_Evaluation) of the given legal move.
+  // Returns the material (in centipawns) won by the current player when both players keep recapturing on the
+  // destination square with their least valuable attacker, and may stop recapturing whenever it does not gain material.
+  // Pins are not accounted for.
+  int32_t see(const Move &move) const;
+
   // Return whether it is white to move.
   inline bool is_white_to_move() const { return is_white_turn; }
 
   // Returns a reference to the opponent of the current player.
   constexpr const Player &opp_player() const;
-  constexpr Player &opp_player();
 
   // Return a new board, where the current player skipped their turn.
   constexpr Board skip_turn() const;
@@ -74,6 +114,13 @@ public:
   // Returns the bitboard for the en passant bit.
   constexpr Bitboard get_en_passant() const;
 
+  // Returns the number of plies since the last capture or pawn move (for the fifty move rule).
+  constexpr int16_t get_halfmove_clock() const;
+
+  // Returns the type of the piece (of either color) on the given square, or PieceType::None if it is empty.
+  // `square` must have exactly one bit set, otherwise it is undefined behavior.
+  constexpr PieceType piece_at(Bitboard square) const;
+
   // Returns a 8x8 newline delimited string represenation of the board.
   constexpr std::string to_string() const;
 
@@ -84,15 +131,21 @@ public:
     uint64_t hash;
     constexpr bool operator==(const Hash &other) const { return hash == other.hash; }
     constexpr bool is_null() const { return hash == 0; }
-    // A deterministic mapping from Hash to an integer in [0, n).
-    constexpr size_t to_index(size_t n) const { return hash % n; }
+    // A deterministic mapping from Hash to an integer in [0, n). This is a multiply-shift rather than a modulo, as it
+    // needs a multiplication instead of a division, and is unbiased as Zobrist hashes are uniformly distributed.
+    constexpr size_t to_index(size_t n) const {
+      return static_cast<size_t>((static_cast<unsigned __int128>(hash) * n) >> 64);
+    }
 
     // A null hash (highly likely) differs from the hash of any valid board.
     static const Hash null;
   };
-  // Returns a hash of this board.
+  // Returns a hash of this board. This is maintained incrementally, hence it is cheap to call.
   constexpr Hash get_hash() const;
 
+  // Computes the hash of this board from scratch. Prefer `get_hash()`, which returns the same value in O(1).
+  constexpr Hash compute_hash() const;
+
   // Returns true if the game has ended.
   bool is_game_over() const;
 
@@ -105,6 +158,9 @@ public:
   // Else returns the score (-1 if black won, 0 if draw, 1 if white won).
   std::optional<int32_t> get_score() const;
 
+  // Same as `get_score()`, where `info` is the information about this board.
+  std::optional<int32_t> get_score(const BoardInfo &info) const;
+
   // Returns std::nullopt if the game has not ended.
   // Else returns the score (-1 if black won, 0 if draw, 1 if white won).
   // This accounts for threefold repetition.
@@ -112,6 +168,11 @@ public:
     requires IsRepetitionTracker<RepetitionTracker>
   std::optional<int32_t> get_score(const RepetitionTracker &repetition_tracker) const;
 
+  // Same as `get_score(repetition_tracker)`, where `info` is the information about this board.
+  template <typename RepetitionTracker>
+    requires IsRepetitionTracker<RepetitionTracker>
+  std::optional<int32_t> get_score(const BoardInfo &info, const RepetitionTracker &repetition_tracker) const;
+
   // Two boards are equal if they have the same position and flags.
   constexpr bool operator==(const Board &other) const;
 
@@ -126,6 +187,23 @@ private:
   // Keeps track of number of plies without capture / pawn pushes (for fifty move rule).
   int16_t halfmove_clock;
   bool is_white_turn;
+  // The type of the piece on each square (indexed by square index), kept in sync with the players' bitboards.
+  std::array<PieceType, 64> mailbox;
+  // Zobrist hash of the board, updated incrementally by `apply_move` and `skip_turn`.
+  Hash hash;
+
+  // Mutable references to the players. These are private, as mutating the players directly would invalidate `hash`.
+  constexpr Player &cur_player();
+  constexpr Player &opp_player();
+
+  // Returns the Zobrist key of the current castling rights.
+  constexpr uint64_t castling_key() const;
+
+  // Computes the mailbox from the players' bitboards.
+  constexpr std::array<PieceType, 64> compute_mailbox() const;
+
+  // Sets the castling rights of the given player.
+  static constexpr void set_castling_rights(Player &player, bool can_castle_kingside, bool can_castle_queenside);
 };
 
 // ========== IMPLEMENTATIONS ==========
@@ -135,7 +213,9 @@ constexpr Board::Board(Player white, Player black, Bitboard en_passant_bit, bool
       black{black},
       en_passant_bit{en_passant_bit},
       halfmove_clock{halfmove_clock},
-      is_white_turn{is_white_turn} {}
+      is_white_turn{is_white_turn},
+      mailbox{compute_mailbox()},
+      hash{compute_hash()} {}
 
 constexpr Board Board::initial() {
   return Board(Player::white_initial(), Player::black_initial(), Bitboard::empty, true);
@@ -143,67 +223,161 @@ constexpr Board Board::initial() {
 
 constexpr Board Board::apply_move(const Move &move) const {
   Board board = *this;
-  Player &cur = board.cur_player();
-  Player &opp = board.opp_player();
+  board.make_move(move);
+  return board;
+}
+
+constexpr Board::UndoInfo Board::make_move(const Move &move) {
+  const UndoInfo undo_info{hash.hash,
+                           en_passant_bit,
+                           halfmove_clock,
+                           white.can_castle_kingside(),
+                           white.can_castle_queenside(),
+                           black.can_castle_kingside(),
+                           black.can_castle_queenside()};
+  Player &cur = cur_player();
+  Player &opp = opp_player();
+  const Color cur_color = get_color();
+  const Color opp_color = cur_color.flip();
   const PieceType piece = move.get_piece();
   const Bitboard from = move.get_from();
   const Bitboard to = move.get_to();
+  uint64_t &new_hash = hash.hash;
+
+  new_hash ^= zobrist::en_passant(en_passant_bit) ^ zobrist::black_to_move();
 
   cur[piece] ^= from | to;
+  new_hash ^= zobrist::piece(cur_color, piece, from) ^ zobrist::piece(cur_color, piece, to);
+  mailbox[from.to_index()] = PieceType::None;
+  mailbox[to.to_index()] = piece;
 
   // Update castling flag.
-  if (move.get_captured_piece() == PieceType::Rook) {
-    if (to == (is_white_turn ? Bitboard::H8 : Bitboard::H1)) opp.disable_kingside_castling();
-    if (to == (is_white_turn ? Bitboard::A8 : Bitboard::A1)) opp.disable_queenside_castling();
-  }
-  if (piece == PieceType::King) {
-    cur.disable_castling();
-  } else if (piece == PieceType::Rook) {
-    if (from == (is_white_turn ? Bitboard::H1 : Bitboard::H8)) cur.disable_kingside_castling();
-    if (from == (is_white_turn ? Bitboard::A1 : Bitboard::A8)) cur.disable_queenside_castling();
+  // The hash of the castling rights is only updated for the moves that can change them, as this is a hot path.
+  if (move.get_captured_piece() == PieceType::Rook || piece == PieceType::King || piece == PieceType::Rook) {
+    new_hash ^= castling_key();
+    if (move.get_captured_piece() == PieceType::Rook) {
+      if (to == (is_white_turn ? Bitboard::H8 : Bitboard::H1)) opp.disable_kingside_castling();
+      if (to == (is_white_turn ? Bitboard::A8 : Bitboard::A1)) opp.disable_queenside_castling();
+    }
+    if (piece == PieceType::King) {
+      cur.disable_castling();
+    } else if (piece == PieceType::Rook) {
+      if (from == (is_white_turn ? Bitboard::H1 : Bitboard::H8)) cur.disable_kingside_castling();
+      if (from == (is_white_turn ? Bitboard::A1 : Bitboard::A8)) cur.disable_queenside_castling();
+    }
+    new_hash ^= castling_key();
   }
 
-  if (move.is_capture()) {
+  const bool is_en_passant = piece == PieceType::Pawn && to == en_passant_bit;
+  if (move.is_capture() && !is_en_passant) {
     opp[move.get_captured_piece()] &= ~to;
+    new_hash ^= zobrist::piece(opp_color, move.get_captured_piece(), to);
   }
 
   // Handle castling.
   if (piece == PieceType::King) {
     if (to == from << 2) {  // Kingside castling.
       cur[PieceType::Rook] ^= from << 1 | from << 3;
+      new_hash ^= zobrist::piece(cur_color, PieceType::Rook, from << 1) ^
+                  zobrist::piece(cur_color, PieceType::Rook, from << 3);
+      mailbox[(from << 1).to_index()] = PieceType::Rook;
+      mailbox[(from << 3).to_index()] = PieceType::None;
     } else if (to == from >> 2) {  // Queenside castling.
       cur[PieceType::Rook] ^= from >> 1 | from >> 4;
+      new_hash ^= zobrist::piece(cur_color, PieceType::Rook, from >> 1) ^
+                  zobrist::piece(cur_color, PieceType::Rook, from >> 4);
+      mailbox[(from >> 1).to_index()] = PieceType::Rook;
+      mailbox[(from >> 4).to_index()] = PieceType::None;
     }
   }
 
   // Handle en passant's capture.
-  if (piece == PieceType::Pawn && to == en_passant_bit) {
-    opp[PieceType::Pawn] ^= is_white_turn ? en_passant_bit >> 8 : en_passant_bit << 8;
+  if (is_en_passant) {
+    const Bitboard captured_pawn = is_white_turn ? en_passant_bit >> 8 : en_passant_bit << 8;
+    opp[PieceType::Pawn] ^= captured_pawn;
+    new_hash ^= zobrist::piece(opp_color, PieceType::Pawn, captured_pawn);
+    mailbox[captured_pawn.to_index()] = PieceType::None;
   }
 
   // Update en passant flag.
-  board.en_passant_bit = Bitboard::empty;
+  en_passant_bit = Bitboard::empty;
   if (piece == PieceType::Pawn) {
     if (to == from << 16) {
-      board.en_passant_bit = from << 8;
+      en_passant_bit = from << 8;
     } else if (to == from >> 16) {
-      board.en_passant_bit = from >> 8;
+      en_passant_bit = from >> 8;
     }
+    new_hash ^= zobrist::en_passant(en_passant_bit);
   }
 
   // Handle promotions.
   if (move.is_promotion()) {
     cur[move.get_promotion_piece()] ^= to;
     cur[PieceType::Pawn] ^= to;
+    new_hash ^=
+        zobrist::piece(cur_color, move.get_promotion_piece(), to) ^ zobrist::piece(cur_color, PieceType::Pawn, to);
+    mailbox[to.to_index()] = move.get_promotion_piece();
   }
 
   // Update halfmove clock.
-  if (move.get_piece() == PieceType::Pawn || move.is_capture()) board.halfmove_clock = 0;
-  else board.halfmove_clock++;
+  if (move.get_piece() == PieceType::Pawn || move.is_capture()) halfmove_clock = 0;
+  else halfmove_clock++;
 
-  board.is_white_turn = !board.is_white_turn;
+  is_white_turn = !is_white_turn;
 
-  return board;
+  assert(hash == compute_hash());
+  assert(mailbox == compute_mailbox());
+
+  return undo_info;
+}
+
+constexpr void Board::unmake_move(const Move &move, const UndoInfo &undo_info) {
+  is_white_turn = !is_white_turn;
+  hash.hash = undo_info.hash;
+  en_passant_bit = undo_info.en_passant_bit;
+  halfmove_clock = undo_info.halfmove_clock;
+  set_castling_rights(white, undo_info.white_can_castle_kingside, undo_info.white_can_castle_queenside);
+  set_castling_rights(black, undo_info.black_can_castle_kingside, undo_info.black_can_castle_queenside);
+
+  Player &cur = cur_player();
+  Player &opp = opp_player();
+  const PieceType piece = move.get_piece();
+  const Bitboard from = move.get_from();
+  const Bitboard to = move.get_to();
+
+  if (move.is_promotion()) {
+    cur[move.get_promotion_piece()] ^= to;
+    cur[PieceType::Pawn] ^= to;
+  }
+
+  const bool is_en_passant = piece == PieceType::Pawn && to == en_passant_bit;
+  mailbox[from.to_index()] = piece;
+  mailbox[to.to_index()] = PieceType::None;
+  if (is_en_passant) {
+    const Bitboard captured_pawn = is_white_turn ? en_passant_bit >> 8 : en_passant_bit << 8;
+    opp[PieceType::Pawn] ^= captured_pawn;
+    mailbox[captured_pawn.to_index()] = PieceType::Pawn;
+  } else if (move.is_capture()) {
+    opp[move.get_captured_piece()] |= to;
+    mailbox[to.to_index()] = move.get_captured_piece();
+  }
+
+  if (piece == PieceType::King) {
+    if (to == from << 2) {  // Kingside castling.
+      cur[PieceType::Rook] ^= from << 1 | from << 3;
+      mailbox[(from << 1).to_index()] = PieceType::None;
+      mailbox[(from << 3).to_index()] = PieceType::Rook;
+    } else if (to == from >> 2) {  // Queenside castling.
+      cur[PieceType::Rook] ^= from >> 1 | from >> 4;
+      mailbox[(from >> 1).to_index()] = PieceType::None;
+      mailbox[(from >> 4).to_index()] = PieceType::Rook;
+    }
+  }
+
+  cur[piece] ^= from | to;
+
+  assert(hash == compute_hash());
+  assert(mailbox == compute_mailbox());
 }
 
 constexpr const Player &Board::cur_player() const { return is_white_turn ? white : black; }
@@ -218,6 +392,8 @@ constexpr Board Board::skip_turn() const {
   Board new_board = *this;
   new_board.is_white_turn = !new_board.is_white_turn;
   new_board.en_passant_bit = Bitboard::empty;
+  new_board.hash.hash ^= zobrist::en_passant(en_passant_bit) ^ zobrist::black_to_move();
+  assert(new_board.hash == new_board.compute_hash());
   return new_board;
 }
 
@@ -229,15 +405,17 @@ constexpr const Player &Board::get_player() const {
 
 constexpr Bitboard Board::get_en_passant() const { return en_passant_bit; }
 
+constexpr int16_t Board::get_halfmove_clock() const { return halfmove_clock; }
+
 constexpr std::string Board::to_string() const {
   std::string s;
   for (int y{7}; y >= 0; y--) {
     for (int x{0}; x < 8; x++) {
       Bitboard bit{Bitboard::from_coordinate(y, x)};
       if (white.occupied() & bit) {
-        s += piece::to_colored_char<Color::White>(white.piece_at(bit));
+        s += piece::to_colored_char<Color::White>(piece_at(bit));
       } else if (black.occupied() & bit) {
-        s += piece::to_colored_char<Color::Black>(black.piece_at(bit));
+        s += piece::to_colored_char<Color::Black>(piece_at(bit));
       } else {
         s += '.';
       }
@@ -247,30 +425,51 @@ constexpr std::string Board::to_string() const {
   return s;
 }
 
+constexpr PieceType Board::piece_at(Bitboard square) const { return mailbox[square.to_index()]; }
+
 constexpr Color Board::get_color() const { return is_white_turn ? Color::White : Color::Black; }
 
 constexpr Board::Hash Board::Hash::null{0};
 
-constexpr Board::Hash Board::get_hash() const {
-  // This uses a polynomial rolling hash (modulo 1<<64).
-  // I have no idea if this sufficiently collision resistant, but it is faster than Zobrist hashing.
-  const uint64_t prime{888888877777777};
-  uint64_t hash{0};
-  hash += is_white_turn;
-  hash *= prime;
-  hash += static_cast<uint64_t>(en_passant_bit);
-  hash *= prime;
-  for (const Player &player : {get_player<Color::White>(), get_player<Color::Black>()}) {
-    hash += player.can_castle_kingside();
-    hash *= prime;
-    hash += player.can_castle_queenside();
-    hash *= prime;
+constexpr Board::Hash Board::get_hash() const { return hash; }
+
+constexpr Board::Hash Board::compute_hash() const {
+  uint64_t new_hash{castling_key() ^ zobrist::en_passant(en_passant_bit)};
+  if (!is_white_turn) new_hash ^= zobrist::black_to_move();
+  for (const Color color : {Color::White, Color::Black}) {
+    const Player &player = color == Color::White ? white : black;
     for (int piece{0}; piece < 6; piece++) {
-      hash += static_cast<uint64_t>(player[static_cast<PieceType>(piece)]);
-      hash *= prime;
+      for (const Bitboard bit : player[static_cast<PieceType>(piece)].iterate()) {
+        new_hash ^= zobrist::piece(color, static_cast<PieceType>(piece), bit);
+      }
     }
   }
-  return Hash{hash};
+  return Hash{new_hash};
+}
+
+constexpr uint64_t Board::castling_key() const {
+  return zobrist::castling(white.can_castle_kingside(), white.can_castle_queenside(), black.can_castle_kingside(),
+                           black.can_castle_queenside());
+}
+
+constexpr std::array<PieceType, 64> Board::compute_mailbox() const {
+  std::array<PieceType, 64> new_mailbox;
+  new_mailbox.fill(PieceType::None);
+  for (const Player *player : {&white, &black}) {
+    for (int piece{0}; piece < 6; piece++) {
+      for (const Bitboard bit : (*player)[static_cast<PieceType>(piece)].iterate()) {
+        new_mailbox[bit.to_index()] = static_cast<PieceType>(piece);
+      }
+    }
+  }
+  return new_mailbox;
+}
+
+constexpr void Board::set_castling_rights(Player &player, bool can_castle_kingside, bool can_castle_queenside) {
+  if (can_castle_kingside) player.enable_kingside_castling();
+  else player.disable_kingside_castling();
+  if (can_castle_queenside) player.enable_queenside_castling();
+  else player.disable_queenside_castling();
 }
 
 template <typename RepetitionTracker>
@@ -286,6 +485,13 @@ std::optional<int32_t> Board::get_score(const RepetitionTracker &repetition_trac
   return get_score();
 }
 
+template <typename RepetitionTracker>
+  requires IsRepetitionTracker<RepetitionTracker>
+std::optional<int32_t> Board::get_score(const BoardInfo &info, const RepetitionTracker &repetition_tracker) const {
+  if (repetition_tracker.is_repetition_draw()) return 0;
+  return get_score(info);
+}
+
 constexpr bool Board::operator==(const Board &other) const {
   return white == other.white && black == other.black && en_passant_bit == other.en_passant_bit &&
          halfmove_clock == other.halfmove_clock && is_white_turn == other.is_white_turn;
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "bitboard.h"
+#include "board.h"
+
+namespace chess {
+
+// Information about a board that is needed by move generation and by most queries on the board (e.g. whether the
+// current player is in check or has any move). Computing it is a large part of the cost of each of those queries, so
+// code that makes several queries on the same board (such as a search at each node) should compute it once and pass it
+// to all of them.
+class BoardInfo {
+public:
+  explicit BoardInfo(const Board& board);
+
+  // Returns the board that this information is about. The board must outlive this object.
+  const Board& get_board() const;
+
+  // Returns the opponent pieces that attack the current player's king.
+  Bitboard get_checkers() const;
+
+  // Returns the opponent pieces that pin a piece of the current player to the current player's king.
+  Bitboard get_pinners() const;
+
+  // Returns the current player's pieces that are pinned to the current player's king.
+  Bitboard get_pinned_pieces() const;
+
+  // Returns the squares attacked by the opponent. Sliders attack through the current player's king, so these are
+  // exactly the squares that the king cannot move to.
+  Bitboard get_opp_attacks() const;
+
+  // Returns true if the current player is in check.
+  bool is_in_check() const;
+
+private:
+  const Board& board;
+  Bitboard checkers;
+  Bitboard pinners;
+  Bitboard pinned_pieces;
+  Bitboard opp_attacks;
+
+  // Computes the information above, where `PlayerColor` is the current player.
+  template <Color PlayerColor>
+  void compute();
+};
+
+// ========== IMPLEMENTATIONS ==========
+
+inline const Board& BoardInfo::get_board() const { return board; }
+
+inline Bitboard BoardInfo::get_checkers() const { return checkers; }
+
+inline Bitboard BoardInfo::get_pinners() const { return pinners; }
+
+inline Bitboard BoardInfo::get_pinned_pieces() const { return pinned_pieces; }
+
+inline Bitboard BoardInfo::get_opp_attacks() const { return opp_attacks; }
+
+inline bool BoardInfo::is_in_check() const { return static_cast<bool>(checkers); }
+
+}  // namespace chess
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "board.h"
+#include "constants.h"
+#include "move.h"
+
+namespace chess {
+
+// Same as StackRepetitionTracker, but the positions are stored in a fixed-capacity ring buffer indexed by ply, so that
+// visiting positions never allocates. Only the hash of each position is stored, and the halfmove clock of the board
+// bounds how far back repetitions are searched for.
+// It also detects upcoming repetitions (https://www.chessprogramming.org/Repetitions#Cuckoo), i.e. positions where the
+// current player can repeat an earlier position with a single reversible move.
+// Note that this tracker must have positions added / removed in filo order. Only the last `capacity` positions are
+// stored, and repetitions are searched for within the last `capacity / 2` of them, so fewer than `capacity / 2`
+// positions may be visited on top of a position before it is returned to (e.g. by unwinding the search).
+class FixedRepetitionTracker {
+public:
+  // Maximum number of positions stored at once.
+  static constexpr size_t capacity{1024};
+
+  // Visit a new board position, which was reached from the given move. A null move (e.g. for the first position, or
+  // when a turn is skipped) means that no earlier position can be repeated.
+  constexpr void push(const Board& board, const Move& move = Move::null());
+
+  // Unvisit the last board position.
+  constexpr void pop();
+
+  // Check if the last added board position is a draw.
+  constexpr bool is_repetition_draw() const;
+
+  // Returns the number of positions visited (and not yet unvisited).
+  constexpr size_t ply() const;
+
+  // Check if the current player of `board`, which must be the last added board position, has a reversible move that
+  // repeats an earlier position. If the repeated position was visited within the last `plies_from_root` plies (e.g.
+  // within the search tree), it need only have been seen once, otherwise it must have been seen twice already so that
+  // repeating it is a draw.
+  bool has_upcoming_repetition(const Board& board, size_t plies_from_root) const;
+
+private:
+  struct Position {
+    Board::Hash hash;
+    // Number of earlier positions that may be repeated by this position.
+    int16_t reversible_plies;
+    int16_t repetition_count;
+  };
+  // The position of ply `i` is stored at index `i % capacity`, overwriting the position `capacity` plies before it.
+  std::array<Position, capacity> positions;
+  // Number of positions visited (and not yet unvisited).
+  size_t size{0};
+
+  // Returns the position visited `plies_ago` plies before the last position.
+  constexpr const Position& get(size_t plies_ago) const;
+};
+
+// ========== IMPLEMENTATIONS ==========
+
+constexpr void FixedRepetitionTracker::push(const Board& board, const Move& move) {
+  int16_t reversible_plies{0};
+  if (!move.is_null() && size > 0) {
+    // Positions before the last capture or pawn move can never be repeated. Earlier positions are never looked at
+    // beyond half the capacity, so that positions overwritten by the ring buffer are never looked at.
+    reversible_plies = std::min({board.get_halfmove_clock(), static_cast<int16_t>(get(0).reversible_plies + 1),
+                                 static_cast<int16_t>(capacity / 2)});
+  }
+
+  const Board::Hash hash{board.get_hash()};
+  int16_t repetition_count{1};
+  for (int16_t i{2}; i <= reversible_plies; i += 2) {
+    if (get(i - 1).hash != hash) continue;
+    repetition_count = static_cast<int16_t>(get(i - 1).repetition_count + 1);
+    break;
+  }
+
+  positions[size % capacity] = Position{hash, reversible_plies, repetition_count};
+  size++;
+}
+
+constexpr void FixedRepetitionTracker::pop() { size--; }
+
+constexpr bool FixedRepetitionTracker::is_repetition_draw() const {
+  if (size == 0) return false;
+  return get(0).repetition_count >= constants::threefold_repetition;
+}
+
+constexpr size_t FixedRepetitionTracker::ply() const { return size; }
+
+constexpr const FixedRepetitionTracker::Position& FixedRepetitionTracker::get(size_t plies_ago) const {
+  return positions[(size - 1 - plies_ago) % capacity];
+}
+
+}  // namespace chess
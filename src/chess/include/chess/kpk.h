@@ -0,0 +1,19 @@
+#pragma once
+
+#include <optional>
+
+#include "board.h"
+
+namespace chess::kpk {
+
+// Returns whether the player with the pawn wins the given king and pawn vs king endgame with perfect play (otherwise
+// it is a draw), or std::nullopt if the board has any other pieces.
+// This is looked up in a bitbase of all such positions (https://www.chessprogramming.org/KPK), which is generated by
+// retrograde analysis by `init`, or the first time it is probed.
+std::optional<bool> probe(const Board& board);
+
+// Generates the bitbase if it has not been generated yet. This takes tens of milliseconds, so it should be called
+// before any timed probes (e.g. in a search).
+void init();
+
+}  // namespace chess::kpk
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+namespace chess {
+
+// A read-only memory mapping of a whole file, so that large files (e.g. position datasets) can be read without
+// copying them into buffers.
+class MappedFile {
+public:
+  // How the file is expected to be read, which decides how much of it the OS reads ahead.
+  enum class Access { Sequential, Random };
+
+  // Maps the given file. Throws a `std::runtime_error` if the file cannot be opened or mapped.
+  explicit MappedFile(const std::filesystem::path& path, Access access = Access::Sequential);
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+  ~MappedFile();
+
+  // Returns the contents of the file, which remain valid for the lifetime of this object.
+  std::string_view contents() const;
+
+private:
+  const char* data;
+  size_t size;
+};
+
+// ========== IMPLEMENTATIONS ==========
+
+inline std::string_view MappedFile::contents() const { return {data, size}; }
+
+}  // namespace chess
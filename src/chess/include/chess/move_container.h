@@ -11,6 +11,12 @@ public:
   // Add a new move.
   constexpr void push_back(Move move);
 
+  // Remove the last move. Is UB if there are no moves.
+  constexpr void pop_back();
+
+  // Remove all moves.
+  constexpr void clear();
+
   // Returns true if there are no moves.
   constexpr bool empty() const;
 
@@ -51,6 +57,10 @@ constexpr MoveContainer::MoveContainer() : size_{0} {}
 
 constexpr void MoveContainer::push_back(Move move) { moves[size_++] = move; }
 
+constexpr void MoveContainer::pop_back() { size_--; }
+
+constexpr void MoveContainer::clear() { size_ = 0; }
+
 constexpr size_t MoveContainer::size() const { return size_; }
 
 constexpr Move& MoveContainer::operator[](size_t index) { return moves[index]; }
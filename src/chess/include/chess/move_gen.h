@@ -1,25 +1,154 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+
 #include "board.h"
+#include "board_info.h"
 #include "move_container.h"
 
 namespace chess {
 
+// The functions below that take a BoardInfo are the same as those that take its board, but reuse the information
+// instead of computing it again.
 namespace move_gen {
 // Generate a list of all legal moves.
 MoveContainer generate_moves(const Board& board);
+MoveContainer generate_moves(const BoardInfo& info);
 
 // Generate a list of all legal captures and promotions.
 MoveContainer generate_quiescence_moves(const Board& board);
+MoveContainer generate_quiescence_moves(const BoardInfo& info);
 
 // Generate a list of all legal captures, checks and promotions.
 MoveContainer generate_quiescence_moves_and_checks(const Board& board);
+MoveContainer generate_quiescence_moves_and_checks(const BoardInfo& info);
+
+// Returns the number of legal moves, without generating them.
+size_t count_moves(const Board& board);
+size_t count_moves(const BoardInfo& info);
 
 // Returns true if the current player still has any move to make.
 bool has_moves(const Board& board);
+bool has_moves(const BoardInfo& info);
+
+// Legal moves of a board, along with the score of the game found from the same pass of move generation.
+struct MovesAndScore {
+  MoveContainer moves;
+  // Same as `Board::get_score`. If the game has ended, `moves` is empty.
+  std::optional<int32_t> score;
+};
+
+// Generate a list of all legal moves, along with the score of the game. This is cheaper than calling
+// `Board::get_score` and then generating the moves, as both need a legal move generation pass.
+MovesAndScore generate_moves_and_score(const Board& board);
+MovesAndScore generate_moves_and_score(const BoardInfo& info);
+
+// Same as `generate_moves_and_score`, but accounts for threefold repetition.
+template <typename RepetitionTracker>
+  requires IsRepetitionTracker<RepetitionTracker>
+MovesAndScore generate_moves_and_score(const BoardInfo& info, const RepetitionTracker& repetition_tracker);
+
+// Generate a list of all legal captures and promotions (or all legal moves when in check, as every evasion must be
+// considered), along with the score of the game. Quiet moves are only searched for when there are no captures and
+// promotions, to tell whether the game has ended.
+MovesAndScore generate_quiescence_moves_and_score(const Board& board);
+MovesAndScore generate_quiescence_moves_and_score(const BoardInfo& info);
+
+// Same as `generate_quiescence_moves_and_score`, but accounts for threefold repetition.
+template <typename RepetitionTracker>
+  requires IsRepetitionTracker<RepetitionTracker>
+MovesAndScore generate_quiescence_moves_and_score(const BoardInfo& info, const RepetitionTracker& repetition_tracker);
+
+// Generate a list of all pseudo-legal moves, which follow the movement rules of each piece but may leave the king in
+// check (castling is only generated when legal). This skips computing checks and pins, so together with
+// `is_pseudo_legal_move_legal` on the moves that are actually played, it is cheaper than `generate_moves` when most
+// moves are never played (e.g. at cut-nodes).
+MoveContainer generate_pseudo_legal_moves(const Board& board);
+
+// Generate a list of all pseudo-legal captures and promotions.
+MoveContainer generate_pseudo_legal_quiescence_moves(const Board& board);
+
+// Returns true if the given pseudo-legal move (i.e. generated by `generate_pseudo_legal_moves`) does not leave the
+// king in check.
+bool is_pseudo_legal_move_legal(const Board& board, const Move& move);
 
 // Check if the given square is under attack by the opponent.
 bool is_under_attack(const Board& board, Bitboard square);
+
+// Returns true if the given move is legal. Moves from other positions (e.g. hash moves and killer moves) may be passed.
+bool is_legal(const Board& board, const Move& move);
+bool is_legal(const BoardInfo& info, const Move& move);
 }  // namespace move_gen
 
+// Generates legal moves lazily in stages, so that a search that cuts off early (e.g. on the hash move or the first
+// capture) never pays for generating the later stages. The stages are generated in the order below:
+// 1. The hash move (if it is legal).
+// 2. Captures that do not lose material by static exchange evaluation, and promotions.
+// 3. Killer moves (those that are legal quiet moves).
+// 4. All remaining quiet moves, and the captures that lose material.
+// When the current player is in check, all moves after the hash move are instead generated in a single evasions stage.
+// A move is never generated in more than one stage.
+class StagedMoveGen {
+public:
+  enum class Stage : uint8_t {
+    None,
+    HashMove,
+    Evasions,
+    GoodCapturesAndPromotions,
+    KillerMoves,
+    QuietMovesAndBadCaptures,
+    Done
+  };
+
+  // Only the first `max_killer_moves` killer moves are used.
+  static constexpr size_t max_killer_moves{4};
+
+  // `info` must outlive this object.
+  explicit StagedMoveGen(const BoardInfo& info, Move hash_move = Move::null(),
+                         std::span<const Move> killer_moves = {});
+
+  // Replaces the contents of `moves` with the moves of the next non-empty stage.
+  // Returns false (with `moves` left empty) once all legal moves have been generated.
+  bool next_stage(MoveContainer& moves);
+
+  // Returns the stage of the moves that were last returned by `next_stage`.
+  Stage get_stage() const;
+
+private:
+  const BoardInfo& info;
+  Move hash_move;
+  std::array<Move, max_killer_moves> killer_moves;
+  size_t killer_moves_count;
+  // Moves that were generated by an earlier stage than the one they are returned by: the evasions or captures found
+  // while validating the hash move, and then the bad captures.
+  MoveContainer deferred_moves;
+  bool has_deferred_moves;
+  Stage stage;
+
+  // Generates the moves of the current stage into `moves`.
+  template <Color PlayerColor>
+  void generate_stage(MoveContainer& moves);
+};
+
+// ========== IMPLEMENTATIONS ==========
+
+template <typename RepetitionTracker>
+  requires IsRepetitionTracker<RepetitionTracker>
+move_gen::MovesAndScore move_gen::generate_moves_and_score(const BoardInfo& info,
+                                                           const RepetitionTracker& repetition_tracker) {
+  if (repetition_tracker.is_repetition_draw()) return {MoveContainer{}, 0};
+  return generate_moves_and_score(info);
+}
+
+template <typename RepetitionTracker>
+  requires IsRepetitionTracker<RepetitionTracker>
+move_gen::MovesAndScore move_gen::generate_quiescence_moves_and_score(const BoardInfo& info,
+                                                                      const RepetitionTracker& repetition_tracker) {
+  if (repetition_tracker.is_repetition_draw()) return {MoveContainer{}, 0};
+  return generate_quiescence_moves_and_score(info);
+}
+
 }  // namespace chess
\ No newline at end of file
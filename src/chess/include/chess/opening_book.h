@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include "board.h"
+#include "mapped_file.h"
+#include "move.h"
+
+namespace chess {
+
+// An opening book, which is a file of 16 byte big-endian entries {key, move, weight, learn} sorted by key, with one
+// entry per book move of each position. The file is memory mapped and binary searched, so that probing it takes
+// microseconds and only reads the pages that are needed.
+// The entries are laid out like those of Polyglot books (http://hgm.nubati.net/book_format.html), but the keys are
+// computed from this library's own random numbers rather than Polyglot's Random64 table, so books made by Polyglot
+// tools cannot be read, and books made by this library cannot be read by Polyglot tools. Books must be built with
+// `get_key` and `encode_move` of this library (e.g. by `chess_book_builder`, see tools/book_builder.cpp).
+class OpeningBook {
+public:
+  struct Entry {
+    Move move;
+    uint16_t weight;
+  };
+
+  // An entry as it is stored in the file.
+  struct RawEntry {
+    uint64_t key;
+    uint16_t move;
+    uint16_t weight;
+  };
+
+  // Size of each entry in the file, in bytes.
+  static constexpr size_t entry_size{16};
+
+  // Maps the book at the given path. Throws a `std::runtime_error` if it cannot be read or is not a book.
+  explicit OpeningBook(const std::filesystem::path& path);
+
+  // Returns the book moves of the given board along with their weights, in the order that they are stored. Entries
+  // whose move is not legal (e.g. as their key collides with another position) are skipped.
+  std::vector<Entry> get_entries(const Board& board) const;
+
+  // Returns a book move of the given board, chosen randomly with probability proportional to its weight, or
+  // std::nullopt if the board has no book moves with a positive weight.
+  template <typename RandomGenerator>
+  std::optional<Move> choose_move(const Board& board, RandomGenerator& random) const;
+
+  // Returns the key of the given board in a book. Unlike `Board::get_hash`, this does not change if the Zobrist keys
+  // of the board change, and it ignores an en passant square that no pawn can capture on.
+  static uint64_t get_key(const Board& board);
+
+  // Returns the encoding of the given move in a book (the same as Polyglot's), where castling is written as the king
+  // capturing its own rook.
+  static uint16_t encode_move(const Move& move);
+
+  // Writes a book with the given entries (in any order) to the given path.
+  // Throws a `std::runtime_error` if the file cannot be written.
+  static void write(const std::filesystem::path& path, std::vector<RawEntry> entries);
+
+private:
+  MappedFile file;
+  size_t entry_count;
+
+  // Returns the key of the entry at the given index.
+  uint64_t get_entry_key(size_t index) const;
+};
+
+// ========== IMPLEMENTATIONS ==========
+
+template <typename RandomGenerator>
+std::optional<Move> OpeningBook::choose_move(const Board& board, RandomGenerator& random) const {
+  const std::vector<Entry> entries{get_entries(board)};
+  uint64_t total_weight{0};
+  for (const Entry& entry : entries) total_weight += entry.weight;
+  if (total_weight == 0) return std::nullopt;
+
+  uint64_t chosen_weight{static_cast<uint64_t>(random()) % total_weight};
+  for (const Entry& entry : entries) {
+    if (chosen_weight < entry.weight) return entry.move;
+    chosen_weight -= entry.weight;
+  }
+  return std::nullopt;
+}
+
+}  // namespace chess
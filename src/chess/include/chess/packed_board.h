@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+#include "bitboard.h"
+#include "board.h"
+#include "player.h"
+
+namespace chess {
+
+// A fixed-size (32 byte) binary encoding of a board, for storing many boards densely (e.g. position datasets and
+// opening books). It is trivially copyable, so arrays of packed boards can be read and written with memcpy, and
+// unpacking is much cheaper than parsing FEN.
+// Multi-byte fields are stored in native byte order.
+class PackedBoard {
+public:
+  constexpr PackedBoard() = default;
+
+  // Packs the given board, which must have at most 32 pieces.
+  static constexpr PackedBoard pack(const Board &board);
+
+  // Returns the board that was packed.
+  constexpr Board unpack() const;
+
+  constexpr bool operator==(const PackedBoard &other) const = default;
+
+private:
+  // Occupied squares of both players.
+  uint64_t occupied{0};
+  // A 4-bit code (the piece type, with the color in the highest bit) for each occupied square in increasing order of
+  // square index. The code of the i-th occupied square is in the low nibble of pieces[i / 2] if i is even.
+  std::array<uint8_t, 16> pieces{};
+  int16_t halfmove_clock{0};
+  // Square index of the en passant square, or 0 if there is none (square 0 is never an en passant square).
+  uint8_t en_passant{0};
+  // Bits for the side to move and the castling rights (see the flags below).
+  uint8_t flags{0};
+
+  static constexpr uint8_t white_to_move_flag{1 << 0};
+  static constexpr uint8_t white_kingside_flag{1 << 1};
+  static constexpr uint8_t white_queenside_flag{1 << 2};
+  static constexpr uint8_t black_kingside_flag{1 << 3};
+  static constexpr uint8_t black_queenside_flag{1 << 4};
+  static constexpr uint8_t black_piece_code{1 << 3};
+};
+
+static_assert(sizeof(PackedBoard) == 32);
+static_assert(std::is_trivially_copyable_v<PackedBoard>);
+
+// ========== IMPLEMENTATIONS ==========
+
+constexpr PackedBoard PackedBoard::pack(const Board &board) {
+  const Player &white{board.get_player<Color::White>()};
+  const Player &black{board.get_player<Color::Black>()};
+  PackedBoard packed{};
+  packed.occupied = static_cast<uint64_t>(white.occupied() | black.occupied());
+
+  size_t i{0};
+  for (const Bitboard square : Bitboard{packed.occupied}.iterate()) {
+    uint8_t code{static_cast<uint8_t>(board.piece_at(square))};
+    if (black.occupied() & square) code |= black_piece_code;
+    packed.pieces[i / 2] |= static_cast<uint8_t>(code << (4 * (i % 2)));
+    i++;
+  }
+
+  packed.halfmove_clock = board.get_halfmove_clock();
+  if (board.get_en_passant()) packed.en_passant = static_cast<uint8_t>(board.get_en_passant().to_index());
+  if (board.get_color() == Color::White) packed.flags |= white_to_move_flag;
+  if (white.can_castle_kingside()) packed.flags |= white_kingside_flag;
+  if (white.can_castle_queenside()) packed.flags |= white_queenside_flag;
+  if (black.can_castle_kingside()) packed.flags |= black_kingside_flag;
+  if (black.can_castle_queenside()) packed.flags |= black_queenside_flag;
+  return packed;
+}
+
+constexpr Board PackedBoard::unpack() const {
+  Player white{Player::empty()};
+  Player black{Player::empty()};
+
+  size_t i{0};
+  for (const Bitboard square : Bitboard{occupied}.iterate()) {
+    const uint8_t code{static_cast<uint8_t>((pieces[i / 2] >> (4 * (i % 2))) & 0xF)};
+    Player &player{(code & black_piece_code) ? black : white};
+    player[static_cast<PieceType>(code & ~black_piece_code)] |= square;
+    i++;
+  }
+
+  if (flags & white_kingside_flag) white.enable_kingside_castling();
+  if (flags & white_queenside_flag) white.enable_queenside_castling();
+  if (flags & black_kingside_flag) black.enable_kingside_castling();
+  if (flags & black_queenside_flag) black.enable_queenside_castling();
+  const Bitboard en_passant_bit{en_passant ? Bitboard::from_index(en_passant) : Bitboard::empty};
+  return Board{white, black, en_passant_bit, static_cast<bool>(flags & white_to_move_flag), halfmove_clock};
+}
+
+}  // namespace chess
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "bitboard.h"
+#include "board.h"
+#include "move.h"
+#include "piece.h"
+
+namespace chess {
+
+// A 16-bit encoding of a move, for storing moves densely (e.g. in transposition table entries).
+// Only the squares and the promotion piece are stored. The moved and captured pieces are read back from the board the
+// move is played on when unpacking, so a packed move can only be unpacked against the board it was packed from.
+// Bits 0~5: index of the moved from square.
+// Bits 6~11: index of the moved to square.
+// Bits 12~13: the promotion piece (only relevant if the move is a promotion).
+class PackedMove {
+public:
+  // Construct a packed null move.
+  constexpr PackedMove() = default;
+
+  // Packs the given move.
+  static constexpr PackedMove pack(const Move& move);
+
+  // Returns the move on the given board with the packed squares and promotion piece. If this move was packed on another
+  // board, the returned move need not be legal (or even have a moved piece), so it should be checked for legality.
+  constexpr Move unpack(const Board& board) const;
+
+  // Whether this is a packed null move.
+  constexpr bool is_null() const;
+
+  constexpr bool operator==(const PackedMove& other) const = default;
+
+private:
+  uint16_t value{0};
+
+  constexpr explicit PackedMove(uint16_t value);
+};
+
+static_assert(sizeof(PackedMove) == 2);
+static_assert(std::is_trivially_copyable_v<PackedMove>);
+
+// ========== IMPLEMENTATIONS ==========
+
+constexpr PackedMove::PackedMove(uint16_t value) : value{value} {}
+
+constexpr PackedMove PackedMove::pack(const Move& move) {
+  if (move.is_null()) return PackedMove{};
+  uint16_t value{static_cast<uint16_t>(move.get_from().to_index() | move.get_to().to_index() << 6)};
+  if (move.is_promotion()) value |= static_cast<uint16_t>(static_cast<uint16_t>(move.get_promotion_piece()) << 12);
+  return PackedMove{value};
+}
+
+constexpr Move PackedMove::unpack(const Board& board) const {
+  if (is_null()) return Move::null();
+  const Bitboard from{Bitboard::from_index(value & 0b111111)};
+  const Bitboard to{Bitboard::from_index((value >> 6) & 0b111111)};
+  const PieceType piece{board.piece_at(from)};
+  PieceType captured_piece{board.piece_at(to)};
+  if (piece == PieceType::Pawn) {
+    if (to == board.get_en_passant()) captured_piece = PieceType::Pawn;
+    if (to & (Bitboard::rank_1 | Bitboard::rank_8)) {
+      return Move::promotion(from, to, static_cast<PieceType>((value >> 12) & 0b11), captured_piece);
+    }
+  }
+  return Move::move(from, to, piece, captured_piece);
+}
+
+constexpr bool PackedMove::is_null() const { return value == 0; }
+
+}  // namespace chess
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "board.h"
+#include "mapped_file.h"
+#include "move.h"
+
+namespace chess {
+
+namespace san {
+
+// Returns the legal move of the board written in Standard Algebraic Notation (e.g. `Nbd7`, `exd8=Q+` or `O-O`), or
+// std::nullopt if there is no such move or the notation is ambiguous.
+std::optional<Move> move(std::string_view san_move, const Board& board);
+
+}  // namespace san
+
+// A game read from a PGN file.
+struct PgnGame {
+  // The tag pairs (e.g. `[White "Magnus"]`) before the moves, which view into the file.
+  std::string_view tags;
+  // The position that the game starts from, which is the initial position unless the game has a FEN tag.
+  Board board;
+  // The moves of the game from the starting position, up to the limit of the reader.
+  std::vector<Move> moves;
+  // The game termination marker ("1-0", "0-1", "1/2-1/2" or "*"), which views into the file.
+  std::string_view result;
+
+  // Returns the value of the tag with the given name (without its quotes), or std::nullopt if there is no such tag.
+  std::optional<std::string_view> get_tag(std::string_view name) const;
+};
+
+// Reads the games of a PGN file (https://www.chessprogramming.org/Portable_Game_Notation) lazily, so that databases
+// with millions of games can be streamed in constant memory. Comments, variations and annotations are skipped.
+class PgnReader {
+public:
+  static constexpr size_t all_plies{std::numeric_limits<size_t>::max()};
+
+  // Only the first `max_plies` moves of each game are read, the rest are skipped without being parsed.
+  // Throws a `std::runtime_error` if the file cannot be opened.
+  explicit PgnReader(const std::filesystem::path& path, size_t max_plies = all_plies);
+
+  // Same as above, but only reads the games whose first tag starts in the byte range [begin, end) of the file, so
+  // that the games of a file can be split between threads by splitting its bytes.
+  PgnReader(const std::filesystem::path& path, size_t begin, size_t end, size_t max_plies = all_plies);
+
+  // Returns the next game, or std::nullopt when there are no more games.
+  // Throws a `std::runtime_error` (with the line number) if the game has an invalid tag or move, after which `next`
+  // continues from the following game.
+  std::optional<PgnGame> next();
+
+private:
+  MappedFile file;
+  std::filesystem::path path;
+  size_t offset;
+  size_t end;
+  size_t max_plies;
+
+  // Moves `offset` to the start of the next game at or after the start of the current line.
+  void skip_to_game();
+
+  // Skips the rest of the current game, and throws a `std::runtime_error` describing an error at the given offset.
+  [[noreturn]] void fail(size_t error_offset, std::string_view message);
+};
+
+}  // namespace chess
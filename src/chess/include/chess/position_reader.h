@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+#include "board.h"
+#include "mapped_file.h"
+
+namespace chess {
+
+namespace detail::position_reader {
+// Reads the lines of a memory-mapped file one at a time.
+class LineReader {
+public:
+  explicit LineReader(const std::filesystem::path& path);
+
+  // Returns the next line (without its line ending), or std::nullopt at the end of the file.
+  std::optional<std::string_view> next();
+
+  // Throws a `std::runtime_error` describing an error on the line last returned by `next`.
+  [[noreturn]] void fail(std::string_view message) const;
+
+private:
+  MappedFile file;
+  std::filesystem::path path;
+  size_t offset;
+  size_t line_number;
+};
+}  // namespace detail::position_reader
+
+// A position read from an EPD file (https://www.chessprogramming.org/Extended_Position_Description).
+struct EpdEntry {
+  Board board;
+  // The operations after the position (e.g. `bm Nf3; id "test";`), which view into the file.
+  std::string_view operations;
+};
+
+// Reads the positions of an EPD file lazily, so that files with millions of positions can be streamed.
+// Empty lines and lines starting with '#' are skipped.
+class EpdReader {
+public:
+  // Throws a `std::runtime_error` if the file cannot be opened.
+  explicit EpdReader(const std::filesystem::path& path);
+
+  // Returns the next position, or std::nullopt at the end of the file.
+  // Throws a `std::runtime_error` (with the line number) if a position is invalid.
+  std::optional<EpdEntry> next();
+
+private:
+  detail::position_reader::LineReader lines;
+};
+
+// A position read from a CSV file.
+struct CsvEntry {
+  Board board;
+  // The whole line of the position (including the FEN), which views into the file.
+  std::string_view line;
+};
+
+// Reads the positions of a CSV file (e.g. the Lichess puzzle database) lazily, where one column holds the FEN.
+// Empty lines are skipped.
+class CsvPositionReader {
+public:
+  // `fen_column` is the (0-indexed) column that holds the FEN. If `has_header`, the first line is skipped.
+  // Throws a `std::runtime_error` if the file cannot be opened.
+  CsvPositionReader(const std::filesystem::path& path, size_t fen_column, bool has_header = true);
+
+  // Returns the next position, or std::nullopt at the end of the file.
+  // Throws a `std::runtime_error` (with the line number) if a line has no FEN column or its FEN is invalid.
+  std::optional<CsvEntry> next();
+
+private:
+  detail::position_reader::LineReader lines;
+  size_t fen_column;
+};
+
+}  // namespace chess
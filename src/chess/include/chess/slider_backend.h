@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+namespace chess {
+
+// The implementation used to look up the attacks of sliding pieces (rooks, bishops and queens).
+enum class SliderBackend : uint8_t {
+  Magic,  // Magic bitboards (https://www.chessprogramming.org/Magic_Bitboards). Works on every CPU.
+  Pext,   // Indexes with the BMI2 PEXT instruction, which needs no magic multiply. Only on x86-64 CPUs with BMI2.
+};
+
+namespace slider_backend {
+
+// Returns true if the given backend can be used on this CPU.
+bool is_supported(SliderBackend backend);
+
+// Returns the backend in use. By default, this is the fastest supported backend, which is picked (by CPUID) at startup.
+SliderBackend get();
+
+// Switch to the given backend, which must be supported. This is not thread-safe, and is meant for benchmarks and tests.
+void set(SliderBackend backend);
+
+}  // namespace slider_backend
+
+// ========== IMPLEMENTATIONS ==========
+
+namespace detail {
+extern SliderBackend current_slider_backend;
+}  // namespace detail
+
+inline SliderBackend slider_backend::get() { return detail::current_slider_backend; }
+
+}  // namespace chess
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "board.h"
+#include "color.h"
+#include "mapped_file.h"
+#include "piece.h"
+
+namespace chess {
+
+// The pieces of both players, written as white's pieces then black's pieces (e.g. "KRPvKR").
+class Material {
+public:
+  // Parses the given material. Returns std::nullopt if it is invalid (e.g. a player does not have exactly one king).
+  static std::optional<Material> from_string(std::string_view string);
+
+  // Returns the material of the given board.
+  static Material of(const Board& board);
+
+  // Returns the material in the same format as `from_string` (with pieces in the order KQRBNP).
+  std::string to_string() const;
+
+  // Returns the number of pieces of the given color and type.
+  int count(Color color, PieceType piece) const;
+
+  // Returns the total number of pieces of both players, including kings.
+  int count() const;
+
+  // Returns the same material with the colors of the players swapped.
+  Material flip() const;
+
+  // Returns this material with `count` pieces of the given color and type added (or removed if negative).
+  Material add(Color color, PieceType piece, int count) const;
+
+  bool operator==(const Material& other) const = default;
+
+private:
+  std::array<std::array<uint8_t, 6>, 2> counts{};  // Indexed by [color][piece].
+};
+
+enum class Wdl : int8_t { Loss = -1, Draw = 0, Win = 1 };
+
+// The result of a position with perfect play, from the perspective of the current player.
+struct TablebaseResult {
+  Wdl wdl;
+  // Number of plies until the losing player is checkmated (0 for draws).
+  int plies_to_mate;
+};
+
+// A table of the results of all positions with a given material, generated by chess_tbgen (see tools/tbgen.cpp).
+// The file is memory mapped, so that only the parts of it that are probed are read from disk.
+// The tables assume that neither player can castle or capture en passant.
+class Tablebase {
+public:
+  // Maps the tablebase at the given path. Throws a `std::runtime_error` if it cannot be read or is not a tablebase.
+  explicit Tablebase(const std::filesystem::path& path);
+
+  // Returns the material of the positions in this tablebase.
+  const Material& get_material() const;
+
+  // Returns the result of the given board, which must have the material of this tablebase. Castling rights and en
+  // passant squares are ignored.
+  TablebaseResult probe(const Board& board) const;
+
+private:
+  MappedFile file;
+  Material material;
+  const uint8_t* entries;
+};
+
+// A collection of tablebases, which can be probed for any position with the material of one of them (with the colors
+// of the players in either order).
+class Tablebases {
+public:
+  // Loads all tablebases (files named <material>.cbtb) in the given directory.
+  // Throws a `std::runtime_error` if any of them cannot be read.
+  static Tablebases load_directory(const std::filesystem::path& directory);
+
+  // Adds the given tablebase to this collection.
+  void add(Tablebase tablebase);
+
+  // Returns whether there is a tablebase for the given material (with the colors of the players in either order).
+  bool contains(const Material& material) const;
+
+  // Returns the largest number of pieces (including kings) of any tablebase.
+  int get_max_piece_count() const;
+
+  // Returns the result of the given board, or std::nullopt if there is no tablebase with its material or the board has
+  // castling rights or an en passant capture (which tablebases do not account for). Positions with only the two kings
+  // are draws, and need no tablebase.
+  std::optional<TablebaseResult> probe(const Board& board) const;
+
+  // File extension of tablebases.
+  static constexpr std::string_view extension{".cbtb"};
+
+private:
+  std::vector<Tablebase> tablebases;
+  int max_piece_count{2};
+};
+
+}  // namespace chess
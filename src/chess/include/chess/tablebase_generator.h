@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+#include "tablebase.h"
+
+namespace chess::tablebase_generator {
+
+// Returns the materials that can be reached from the given material with a single capture or promotion (other than
+// those with only the two kings), whose tablebases are needed to generate its tablebase.
+std::vector<Material> get_sub_materials(const Material& material);
+
+// Counts of the results of all legal positions in a generated tablebase.
+struct Stats {
+  size_t wins;
+  size_t draws;
+  size_t losses;
+  // Largest number of plies to mate of any position.
+  int max_plies_to_mate;
+};
+
+// Generates the tablebase of the given material by retrograde analysis, and writes it to the given path. Positions are
+// resolved backwards from checkmates, one ply at a time, and positions that are never resolved are draws. Moves that
+// change the material are looked up in `sub_tablebases`, which must contain every material of `get_sub_materials`.
+// The work of each ply is split between `thread_count` threads.
+// Throws a `std::runtime_error` if a sub tablebase is missing, a mate is too long to be stored (see
+// `detail::tablebase::max_plies_to_mate`), or the file cannot be written.
+Stats generate(const Material& material, const Tablebases& sub_tablebases, const std::filesystem::path& path,
+               size_t thread_count);
+
+}  // namespace chess::tablebase_generator
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "bitboard.h"
+#include "color.h"
+#include "pieces/base_piece.h"
+
+namespace chess {
+
+// Keys for Zobrist hashing (https://www.chessprogramming.org/Zobrist_Hashing).
+// The hash of a board is the XOR of the keys of all its features (pieces, castling rights, en passant square and side
+// to move), which allows the hash to be updated incrementally as moves are made.
+namespace zobrist {
+
+// Returns the key of a `color` piece of type `piece` on `square`.
+// `square` must have exactly one bit set, otherwise it is undefined behavior.
+constexpr uint64_t piece(Color color, PieceType piece, Bitboard square);
+
+// Returns the key of the given combination of castling rights.
+constexpr uint64_t castling(bool white_kingside, bool white_queenside, bool black_kingside, bool black_queenside);
+
+// Returns the key of the given en passant bit (0 if there is no en passant square).
+constexpr uint64_t en_passant(Bitboard en_passant_bit);
+
+// Returns the key that is present iff it is black to move.
+constexpr uint64_t black_to_move();
+
+}  // namespace zobrist
+
+// ========== IMPLEMENTATIONS ==========
+
+namespace detail::zobrist {
+// Returns the next number of splitmix64 (https://prng.di.unimi.it/splitmix64.c), advancing its state.
+constexpr uint64_t splitmix64(uint64_t& state) {
+  uint64_t z = (state += 0x9e3779b97f4a7c15);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+
+struct Keys {
+  std::array<std::array<std::array<uint64_t, 64>, 6>, 2> pieces;  // Indexed by [color][piece][square].
+  std::array<uint64_t, 16> castling;                               // Indexed by the 4 castling rights as bits.
+  std::array<uint64_t, 8> en_passant;                              // Indexed by file.
+  uint64_t black_to_move;
+};
+
+constexpr Keys keys = []() {
+  // Keys are generated by splitmix64 with a fixed seed, so that hashes are deterministic across runs.
+  uint64_t state{0x6a09e667f3bcc908};
+  const auto next = [&state]() { return splitmix64(state); };
+
+  Keys keys{};
+  for (auto& color_keys : keys.pieces) {
+    for (auto& piece_keys : color_keys) {
+      for (auto& key : piece_keys) key = next();
+    }
+  }
+  // Each castling right gets its own key, and a combination of rights is the XOR of their keys.
+  std::array<uint64_t, 4> castling_right_keys{next(), next(), next(), next()};
+  for (size_t rights{0}; rights < keys.castling.size(); rights++) {
+    for (size_t i{0}; i < castling_right_keys.size(); i++) {
+      if (rights >> i & 1) keys.castling[rights] ^= castling_right_keys[i];
+    }
+  }
+  for (auto& key : keys.en_passant) key = next();
+  keys.black_to_move = next();
+  return keys;
+}();
+}  // namespace detail::zobrist
+
+constexpr uint64_t zobrist::piece(Color color, PieceType piece, Bitboard square) {
+  return detail::zobrist::keys.pieces[color.to_index()][static_cast<size_t>(piece)][square.to_index()];
+}
+
+constexpr uint64_t zobrist::castling(bool white_kingside, bool white_queenside, bool black_kingside,
+                                     bool black_queenside) {
+  const size_t rights = static_cast<size_t>(white_kingside) | static_cast<size_t>(white_queenside) << 1 |
+                        static_cast<size_t>(black_kingside) << 2 | static_cast<size_t>(black_queenside) << 3;
+  return detail::zobrist::keys.castling[rights];
+}
+
+constexpr uint64_t zobrist::en_passant(Bitboard en_passant_bit) {
+  if (!en_passant_bit) return 0;
+  return detail::zobrist::keys.en_passant[en_passant_bit.to_index() % 8];
+}
+
+constexpr uint64_t zobrist::black_to_move() { return detail::zobrist::keys.black_to_move; }
+
+}  // namespace chess
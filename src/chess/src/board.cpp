@@ -1,73 +1,128 @@
 #include "board.h"
 
+#include <algorithm>
 #include <array>
-#include <cctype>
+#include <limits>
 #include <random>
-#include <sstream>
+#include <stdexcept>
+#include <string>
 #include <type_traits>
 
 #include "bitboard.h"
+#include "board_info.h"
 #include "constants.h"
 #include "move_gen.h"
 #include "piece.h"
 
 using namespace chess;
 
+namespace {
+// Splits off the next space-separated field of `text`, returning an empty field if there is none.
+std::string_view next_field(std::string_view &text) {
+  const size_t start{std::min(text.find_first_not_of(' '), text.size())};
+  const size_t end{std::min(text.find(' ', start), text.size())};
+  const std::string_view field{text.substr(start, end - start)};
+  text.remove_prefix(end);
+  return field;
+}
+
+// Returns true if `field` is a non-empty base-10 number that fits in `max_value`, and stores it in `value`.
+bool parse_number(std::string_view field, int32_t max_value, int32_t &value) {
+  if (field.empty()) return false;
+  value = 0;
+  for (const char ch : field) {
+    if (ch < '0' || ch > '9') return false;
+    value = value * 10 + (ch - '0');
+    if (value > max_value) return false;
+  }
+  return true;
+}
+}  // namespace
+
 Board Board::from_fen(std::string_view fen) {
+  std::string_view error;
+  const std::optional<Board> board{try_from_fen(fen, &error)};
+  if (!board) throw std::invalid_argument{"Invalid FEN (" + std::string{error} + "): " + std::string{fen}};
+  return *board;
+}
+
+std::optional<Board> Board::try_from_fen(std::string_view fen, std::string_view *error) {
+  const auto fail = [error](std::string_view message) -> std::optional<Board> {
+    if (error) *error = message;
+    return std::nullopt;
+  };
+
   Player white{Player::empty()};
   Player black{Player::empty()};
 
-  // Use stringstream (instead of manually parsing) for clarity,
-  // as this function need not be performant.
-  std::istringstream fen_stream{std::string{fen}};
-  std::string buffer;
-
-  // Pieces.
-  fen_stream >> buffer;
-  std::istringstream pieces_stream{std::move(buffer)};
-  for (int y = 7; y >= 0; y--) {
-    std::string line;
-    std::getline(pieces_stream, line, '/');
-    int x = 0;
-    for (char ch : line) {
-      if (std::isdigit(ch)) {
-        x += static_cast<int>(ch - '0');
-        continue;
-      }
-      bool is_white_piece = std::isupper(ch);
-      PieceType piece = piece::from_char(ch);
-      Player &player = is_white_piece ? white : black;
-      player[piece] |= Bitboard::from_coordinate(y, x);
+  // Pieces, from rank 8 to rank 1.
+  const std::string_view pieces{next_field(fen)};
+  int y{7};
+  int x{0};
+  for (const char ch : pieces) {
+    if (ch == '/') {
+      if (x != 8 || y == 0) return fail("invalid rank");
+      y--;
+      x = 0;
+    } else if (ch >= '1' && ch <= '8') {
+      x += ch - '0';
+      if (x > 8) return fail("invalid rank");
+    } else {
+      constexpr std::string_view piece_chars{"bknpqrBKNPQR"};
+      if (piece_chars.find(ch) == std::string_view::npos) return fail("invalid piece");
+      if (x >= 8) return fail("invalid rank");
+      Player &player{(ch >= 'A' && ch <= 'Z') ? white : black};
+      player[piece::from_char(ch)] |= Bitboard::from_coordinate(y, x);
       x++;
     }
   }
+  if (y != 0 || x != 8) return fail("invalid number of ranks");
+  if (white[PieceType::King].count() != 1 || black[PieceType::King].count() != 1) return fail("invalid kings");
 
   // Side to move.
-  fen_stream >> buffer;
-  bool is_white_turn = buffer[0] == 'w';
+  const std::string_view side{next_field(fen)};
+  if (side != "w" && side != "b") return fail("invalid side to move");
+  const bool is_white_turn{side == "w"};
 
   // Castling rights.
-  fen_stream >> buffer;
-  for (char ch : buffer) {
-    if (ch == '-') continue;
-    bool is_white_piece = std::isupper(ch);
-    Player &player = is_white_piece ? white : black;
-    if (ch == 'K' || ch == 'k') player.enable_kingside_castling();
-    else player.enable_queenside_castling();
+  const std::string_view castling{next_field(fen)};
+  if (castling.empty()) return fail("missing castling rights");
+  if (castling != "-") {
+    for (const char ch : castling) {
+      if (ch == 'K') white.enable_kingside_castling();
+      else if (ch == 'Q') white.enable_queenside_castling();
+      else if (ch == 'k') black.enable_kingside_castling();
+      else if (ch == 'q') black.enable_queenside_castling();
+      else return fail("invalid castling rights");
+    }
   }
 
   // En passant target square.
-  fen_stream >> buffer;
+  const std::string_view en_passant{next_field(fen)};
   Bitboard en_passant_bit{Bitboard::empty};
-  if (buffer[0] != '-') en_passant_bit = Bitboard::from_algebraic(buffer);
-
-  // Halfmove clock.
-  int16_t halfmove_clock;
-  fen_stream >> halfmove_clock;
+  if (en_passant != "-") {
+    if (en_passant.size() != 2 || en_passant[0] < 'a' || en_passant[0] > 'h' ||
+        en_passant[1] != (is_white_turn ? '6' : '3')) {
+      return fail("invalid en passant square");
+    }
+    en_passant_bit = Bitboard::from_algebraic(en_passant);
+  }
 
-  // Fullmove counter (ignored as it's not necessary for engines).
+  // Halfmove clock and fullmove counter, which may both be omitted. The fullmove counter is ignored as it is not
+  // necessary for engines.
+  int32_t halfmove_clock{0};
+  int32_t fullmove_counter{0};
+  const std::string_view halfmove_field{next_field(fen)};
+  if (!halfmove_field.empty() && !parse_number(halfmove_field, std::numeric_limits<int16_t>::max(), halfmove_clock)) {
+    return fail("invalid halfmove clock");
+  }
+  const std::string_view fullmove_field{next_field(fen)};
+  if (!fullmove_field.empty() && !parse_number(fullmove_field, std::numeric_limits<int16_t>::max(), fullmove_counter)) {
+    return fail("invalid fullmove counter");
+  }
+  if (!next_field(fen).empty()) return fail("unexpected trailing fields");
 
-  return Board{white, black, en_passant_bit, is_white_turn, halfmove_clock};
+  return Board{white, black, en_passant_bit, is_white_turn, static_cast<int16_t>(halfmove_clock)};
 }
 
 MoveContainer Board::generate_quiescence_moves() const { return move_gen::generate_quiescence_moves(*this); }
@@ -78,6 +133,8 @@ MoveContainer Board::generate_quiescence_moves_and_checks() const {
 
 MoveContainer Board::generate_moves() const { return move_gen::generate_moves(*this); }
 
+size_t Board::count_moves() const { return move_gen::count_moves(*this); }
+
 bool Board::has_moves() const { return move_gen::has_moves(*this); }
 
 bool Board::is_a_check(const Move &move) const {
@@ -89,12 +146,100 @@ bool Board::is_in_check() const { return is_under_attack(cur_player()[PieceType:
 
 bool Board::is_under_attack(Bitboard square) const { return move_gen::is_under_attack(*this, square); }
 
+Bitboard Board::attackers_to(Bitboard square, Bitboard occupied) const {
+  const Bitboard bishops{white[PieceType::Bishop] | black[PieceType::Bishop] | white[PieceType::Queen] |
+                         black[PieceType::Queen]};
+  const Bitboard rooks{white[PieceType::Rook] | black[PieceType::Rook] | white[PieceType::Queen] |
+                       black[PieceType::Queen]};
+  const Bitboard attackers{(Pawn::attacks<Color::Black>(square) & white[PieceType::Pawn]) |
+                           (Pawn::attacks<Color::White>(square) & black[PieceType::Pawn]) |
+                           (Knight::attacks(square) & (white[PieceType::Knight] | black[PieceType::Knight])) |
+                           (King::attacks(square) & (white[PieceType::King] | black[PieceType::King])) |
+                           (Bishop::attacks(square, occupied) & bishops) | (Rook::attacks(square, occupied) & rooks)};
+  return attackers & occupied;
+}
+
+int32_t Board::see(const Move &move) const {
+  // Values of the pieces (indexed by PieceType) for static exchange evaluation.
+  constexpr std::array<int32_t, 7> values{900, 500, 300, 300, 100, 10000, 0};
+  // Pieces in the order that they are used to recapture.
+  constexpr std::array<PieceType, 6> least_valuable_first{PieceType::Pawn, PieceType::Knight, PieceType::Bishop,
+                                                          PieceType::Rook, PieceType::Queen,  PieceType::King};
+  const auto value = [&values](PieceType piece) { return values[static_cast<size_t>(piece)]; };
+
+  const Bitboard to{move.get_to()};
+  Bitboard occupied{(white.occupied() | black.occupied()) ^ move.get_from()};
+  PieceType captured_piece{move.get_captured_piece()};
+  if (move.get_piece() == PieceType::Pawn && to == en_passant_bit) {
+    occupied ^= is_white_turn ? to >> 8 : to << 8;
+    captured_piece = PieceType::Pawn;
+  }
+  const Bitboard bishops{white[PieceType::Bishop] | black[PieceType::Bishop] | white[PieceType::Queen] |
+                         black[PieceType::Queen]};
+  const Bitboard rooks{white[PieceType::Rook] | black[PieceType::Rook] | white[PieceType::Queen] |
+                       black[PieceType::Queen]};
+
+  // gains[i] is the material won by the player making the i-th capture, if the exchange is stopped after it.
+  std::array<int32_t, 32> gains;
+  size_t depth{0};
+  gains[0] = value(captured_piece);
+  PieceType piece_on_to{move.get_piece()};
+  if (move.is_promotion()) {
+    gains[0] += value(move.get_promotion_piece()) - value(PieceType::Pawn);
+    piece_on_to = move.get_promotion_piece();
+  }
+
+  Bitboard attackers{attackers_to(to, occupied)};
+  bool is_white_capturing{!is_white_turn};
+  while (true) {
+    const Player &player{is_white_capturing ? white : black};
+    const Bitboard player_attackers{attackers & player.occupied()};
+    if (!player_attackers) break;
+
+    PieceType attacker_piece{PieceType::None};
+    for (const PieceType piece : least_valuable_first) {
+      if (player_attackers & player[piece]) {
+        attacker_piece = piece;
+        break;
+      }
+    }
+    // The king cannot capture a defended piece.
+    if (attacker_piece == PieceType::King && (attackers & ~player.occupied())) break;
+
+    depth++;
+    gains[depth] = value(piece_on_to) - gains[depth - 1];
+
+    const Bitboard attacker{(player_attackers & player[attacker_piece]).lsb()};
+    occupied ^= attacker;
+    attackers ^= attacker;
+    piece_on_to = attacker_piece;
+    // Reveal the sliders behind the attacker.
+    if (attacker_piece == PieceType::Pawn || attacker_piece == PieceType::Bishop ||
+        attacker_piece == PieceType::Queen) {
+      attackers |= Bishop::attacks(to, occupied) & bishops & occupied;
+    }
+    if (attacker_piece == PieceType::Rook || attacker_piece == PieceType::Queen) {
+      attackers |= Rook::attacks(to, occupied) & rooks & occupied;
+    }
+    is_white_capturing = !is_white_capturing;
+  }
+
+  // Each player only makes a capture if it gains more than stopping the exchange before it.
+  for (; depth > 0; depth--) gains[depth - 1] = -std::max(-gains[depth - 1], gains[depth]);
+  return gains[0];
+}
+
 bool Board::is_game_over() const { return get_score().has_value(); }
 
 std::optional<int32_t> Board::get_score() const {
   if (halfmove_clock >= constants::fifty_move_rule_plies) return 0;  // Draw by fifty move rule.
-  if (has_moves()) return std::nullopt;                              // Game not over.
-  if (!is_in_check()) return 0;                                      // Stalemate.
+  return get_score(BoardInfo{*this});
+}
+
+std::optional<int32_t> Board::get_score(const BoardInfo &info) const {
+  if (halfmove_clock >= constants::fifty_move_rule_plies) return 0;  // Draw by fifty move rule.
+  if (move_gen::has_moves(info)) return std::nullopt;                // Game not over.
+  if (!info.is_in_check()) return 0;                                 // Stalemate.
   if (is_white_turn) return -1;                                      // White is checkmated.
   else return 1;                                                     // Black is checkmated.
 }
@@ -107,10 +252,9 @@ std::string Board::to_fen() const {
     auto empty_count = 0;
     for (auto x = 0; x < 8; x++) {
       const auto bit = Bitboard::from_coordinate(y, x);
-      const auto white_piece = get_player<Color::White>().piece_at(bit);
-      const auto black_piece = get_player<Color::Black>().piece_at(bit);
+      const auto piece = piece_at(bit);
 
-      if (white_piece == PieceType::None && black_piece == PieceType::None) {
+      if (piece == PieceType::None) {
         empty_count++;
         continue;
       }
@@ -121,8 +265,8 @@ std::string Board::to_fen() const {
       }
 
       const auto piece_char = [&]() {
-        if (white_piece != PieceType::None) return piece::to_colored_char<Color::White>(white_piece);
-        return piece::to_colored_char<Color::Black>(black_piece);
+        if (white.occupied() & bit) return piece::to_colored_char<Color::White>(piece);
+        return piece::to_colored_char<Color::Black>(piece);
       }();
       fen += piece_char;
     }
@@ -0,0 +1,42 @@
+#include "board_info.h"
+
+#include "piece.h"
+
+using namespace chess;
+
+BoardInfo::BoardInfo(const Board& board) : board{board} {
+  if (board.is_white_to_move()) compute<Color::White>();
+  else compute<Color::Black>();
+}
+
+template <Color PlayerColor>
+void BoardInfo::compute() {
+  const Player& cur_player{board.get_player<PlayerColor>()};
+  const Player& opp_player{board.get_player<PlayerColor.flip()>()};
+  const Bitboard cur_occupied{cur_player.occupied()};
+  const Bitboard total_occupied{cur_occupied | opp_player.occupied()};
+  const Bitboard king{cur_player[PieceType::King]};
+  const Bitboard opp_bishops{opp_player[PieceType::Bishop] | opp_player[PieceType::Queen]};
+  const Bitboard opp_rooks{opp_player[PieceType::Rook] | opp_player[PieceType::Queen]};
+
+  const Bitboard king_bishop_rays{Bishop::attacks(king, total_occupied)};
+  const Bitboard king_rook_rays{Rook::attacks(king, total_occupied)};
+  const Bitboard slider_checkers{(king_bishop_rays & opp_bishops) | (king_rook_rays & opp_rooks)};
+  checkers = slider_checkers | (Knight::attacks(king) & opp_player[PieceType::Knight]) |
+             (Pawn::attacks<PlayerColor>(king) & opp_player[PieceType::Pawn]);
+
+  // Sliders that only attack the king once all of my pieces on the king's rays are removed are pinning one of them.
+  const Bitboard potential_pinned_pieces{(king_bishop_rays | king_rook_rays) & cur_occupied};
+  const Bitboard xray_occupied{total_occupied ^ potential_pinned_pieces};
+  pinners = ((Bishop::attacks(king, xray_occupied) & opp_bishops) | (Rook::attacks(king, xray_occupied) & opp_rooks)) ^
+            slider_checkers;
+  pinned_pieces = Bitboard::empty;
+  for (const Bitboard pinner : pinners.iterate()) pinned_pieces ^= king.until(pinner) & cur_occupied;
+
+  const Bitboard occupied_without_king{total_occupied ^ king};
+  opp_attacks = Pawn::attacks<PlayerColor.flip()>(opp_player[PieceType::Pawn]) |
+                King::attacks(opp_player[PieceType::King]);
+  for (const Bitboard knight : opp_player[PieceType::Knight].iterate()) opp_attacks |= Knight::attacks(knight);
+  for (const Bitboard bishop : opp_bishops.iterate()) opp_attacks |= Bishop::attacks(bishop, occupied_without_king);
+  for (const Bitboard rook : opp_rooks.iterate()) opp_attacks |= Rook::attacks(rook, occupied_without_king);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "color.h"
+#include "pieces/base_piece.h"
+#include "zobrist.h"
+
+namespace chess::detail::book_keys {
+
+// The keys of opening book positions. They are indexed like Polyglot's Random64 table
+// (http://hgm.nubati.net/book_format.html), but are not its values, so the keys of a position differ from Polyglot's.
+// The key of a position is the XOR of the keys of its features, as in `Board::get_hash`, but the keys are separate from
+// this library's Zobrist keys, so that changing those does not invalidate existing books.
+
+// Pieces are keyed at 64 * kind + square, where the kinds are numbered from the black pawn (0) and white pawn (1) up to
+// the black king (10) and white king (11).
+constexpr size_t piece_offset{0};
+// Castling rights, in the order white kingside, white queenside, black kingside, black queenside.
+constexpr size_t castling_offset{768};
+// En passant, indexed by file.
+constexpr size_t en_passant_offset{772};
+// Present iff it is white to move.
+constexpr size_t turn_offset{780};
+constexpr size_t key_count{781};
+
+// The kind of each piece type (of black), indexed by `PieceType`.
+constexpr std::array<size_t, 6> piece_kinds{
+    8,   // Queen
+    6,   // Rook
+    4,   // Bishop
+    2,   // Knight
+    0,   // Pawn
+    10,  // King
+};
+
+constexpr std::array<uint64_t, key_count> keys = []() {
+  // Generated with a different seed than the Zobrist keys, so that the two hashes of a board are unrelated.
+  uint64_t state{0xbb67ae8584caa73b};
+  std::array<uint64_t, key_count> keys{};
+  for (uint64_t& key : keys) key = zobrist::splitmix64(state);
+  return keys;
+}();
+
+// Returns the index of the key of a `color` piece of type `piece` on the square with the given index.
+constexpr size_t piece(Color color, PieceType piece, size_t square) {
+  return piece_offset + 64 * (piece_kinds[static_cast<size_t>(piece)] + color.to_index()) + square;
+}
+
+}  // namespace chess::detail::book_keys
@@ -0,0 +1,104 @@
+#include "fixed_repetition_tracker.h"
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+#include "zobrist.h"
+
+using namespace chess;
+
+namespace {
+// Cuckoo hash table of the hash differences made by all reversible moves (of non-pawn pieces between two squares on
+// an empty board), so that a move can be looked up from the difference of the hashes of two positions
+// (https://www.chessprogramming.org/Repetitions#Cuckoo).
+struct CuckooTable {
+  static constexpr size_t size{8192};
+  std::array<uint64_t, size> keys;
+  std::array<std::pair<uint8_t, uint8_t>, size> squares;  // The squares of the move with each key.
+
+  static constexpr size_t first_index(uint64_t key) { return key & (size - 1); }
+  static constexpr size_t second_index(uint64_t key) { return (key >> 16) & (size - 1); }
+};
+
+// Whether a piece of the given type can move between the two squares on an empty board.
+constexpr bool can_move_between(PieceType piece, int from_index, int to_index) {
+  const int delta_y{to_index / 8 - from_index / 8};
+  const int delta_x{to_index % 8 - from_index % 8};
+  const bool is_straight{delta_y == 0 || delta_x == 0};
+  const bool is_diagonal{delta_y == delta_x || delta_y == -delta_x};
+  switch (piece) {
+    case PieceType::Queen:
+      return is_straight || is_diagonal;
+    case PieceType::Rook:
+      return is_straight;
+    case PieceType::Bishop:
+      return is_diagonal;
+    case PieceType::Knight:
+      return delta_y * delta_y + delta_x * delta_x == 5;
+    case PieceType::King:
+      return delta_y * delta_y + delta_x * delta_x <= 2;
+    default:
+      return false;
+  }
+}
+
+constexpr CuckooTable cuckoo_table = []() {
+  CuckooTable table{};
+  constexpr std::array<PieceType, 5> pieces{PieceType::Queen, PieceType::Rook, PieceType::Bishop, PieceType::Knight,
+                                            PieceType::King};
+  for (const Color color : {Color::White, Color::Black}) {
+    for (const PieceType piece : pieces) {
+      for (int from_index{0}; from_index < 64; from_index++) {
+        for (int to_index{from_index + 1}; to_index < 64; to_index++) {
+          if (!can_move_between(piece, from_index, to_index)) continue;
+          uint64_t key{zobrist::piece(color, piece, Bitboard::from_index(from_index)) ^
+                       zobrist::piece(color, piece, Bitboard::from_index(to_index)) ^ zobrist::black_to_move()};
+          std::pair<uint8_t, uint8_t> squares{static_cast<uint8_t>(from_index), static_cast<uint8_t>(to_index)};
+          // Insert into the first slot, and move any displaced entry to its other slot until an empty slot is found.
+          size_t index{CuckooTable::first_index(key)};
+          while (true) {
+            std::swap(table.keys[index], key);
+            std::swap(table.squares[index], squares);
+            if (key == 0) break;
+            index = index == CuckooTable::first_index(key) ? CuckooTable::second_index(key)
+                                                           : CuckooTable::first_index(key);
+          }
+        }
+      }
+    }
+  }
+  return table;
+}();
+}  // namespace
+
+bool FixedRepetitionTracker::has_upcoming_repetition(const Board& board, size_t plies_from_root) const {
+  const size_t reversible_plies{static_cast<size_t>(get(0).reversible_plies)};
+  if (reversible_plies < 3) return false;
+
+  const Bitboard occupied{board.get_player<Color::White>().occupied() | board.get_player<Color::Black>().occupied()};
+  const uint64_t hash{get(0).hash.hash};
+  // XOR of the hash differences made by the opponent's moves since the earlier position. If this is 0, then the
+  // opponent's pieces are back where they were, so only the current player's pieces differ.
+  uint64_t opponent_difference{hash ^ get(1).hash.hash ^ zobrist::black_to_move()};
+  for (size_t i{3}; i <= reversible_plies; i += 2) {
+    opponent_difference ^= get(i - 1).hash.hash ^ get(i).hash.hash ^ zobrist::black_to_move();
+    if (opponent_difference != 0) continue;
+
+    const uint64_t key{hash ^ get(i).hash.hash};
+    size_t index{CuckooTable::first_index(key)};
+    if (cuckoo_table.keys[index] != key) {
+      index = CuckooTable::second_index(key);
+      if (cuckoo_table.keys[index] != key) continue;
+    }
+
+    // The move must not be blocked, and must be made by the current player.
+    const Bitboard from{Bitboard::from_index(cuckoo_table.squares[index].first)};
+    const Bitboard to{Bitboard::from_index(cuckoo_table.squares[index].second)};
+    if (from.until(to) & occupied) continue;
+    if (!(board.cur_player().occupied() & (from | to))) continue;
+
+    if (i < plies_from_root || get(i).repetition_count >= 2) return true;
+  }
+  return false;
+}
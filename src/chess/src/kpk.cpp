@@ -0,0 +1,168 @@
+#include "kpk.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bitboard.h"
+#include "piece.h"
+
+using namespace chess;
+
+namespace {
+// Positions are normalized so that white has the pawn, and the pawn is on files A to D. A position is then indexed by
+// the side to move (2), the white king (64), the black king (64), and the pawn (4 files and 6 ranks).
+constexpr size_t position_count{2 * 64 * 64 * 4 * 6};
+
+constexpr size_t to_index(bool is_white_turn, Bitboard white_king, Bitboard black_king, Bitboard pawn) {
+  const size_t pawn_index{static_cast<size_t>(pawn.to_index())};
+  return static_cast<size_t>(!is_white_turn) | static_cast<size_t>(white_king.to_index()) << 1 |
+         static_cast<size_t>(black_king.to_index()) << 7 | (pawn_index % 8) << 13 | (pawn_index / 8 - 1) << 15;
+}
+
+// Results are bit flags, so that the results of all moves from a position can be combined with bitwise or.
+enum Result : uint8_t { Invalid = 0, Unknown = 1 << 0, Draw = 1 << 1, Win = 1 << 2 };
+
+struct Position {
+  bool is_white_turn;
+  Bitboard white_king;
+  Bitboard black_king;
+  Bitboard pawn;
+};
+
+// Returns the result of the position that is known without looking at the results of other positions.
+Result get_initial_result(const Position& position) {
+  const auto& [is_white_turn, white_king, black_king, pawn] = position;
+  if (white_king == black_king || white_king == pawn || black_king == pawn) return Invalid;
+  if (King::attacks(white_king) & black_king) return Invalid;
+
+  if (is_white_turn) {
+    // It cannot be white's turn while black is in check.
+    if (Pawn::attacks<Color::White>(pawn) & black_king) return Invalid;
+
+    // The pawn promotes, and the queen cannot be captured.
+    const Bitboard promotion_square{pawn << 8};
+    if ((pawn & Bitboard::rank_7) && !((white_king | black_king) & promotion_square) &&
+        (!(King::attacks(black_king) & promotion_square) || (King::attacks(white_king) & promotion_square))) {
+      return Win;
+    }
+  } else {
+    // Stalemate, or the pawn is captured.
+    const Bitboard black_king_moves{King::attacks(black_king) &
+                                    ~(King::attacks(white_king) | Pawn::attacks<Color::White>(pawn))};
+    if (!black_king_moves || (black_king_moves & pawn)) return Draw;
+  }
+  return Unknown;
+}
+
+// Returns the result of the position from the results of the positions after each move, which may still be unknown.
+Result get_result(const Position& position, const std::vector<Result>& results) {
+  const auto& [is_white_turn, white_king, black_king, pawn] = position;
+  uint8_t move_results{0};
+  if (is_white_turn) {
+    for (const Bitboard to : King::attacks(white_king).iterate()) {
+      move_results |= results[to_index(false, to, black_king, pawn)];
+    }
+    // Promotions are already accounted for by the initial result.
+    const Bitboard pawn_pushes{Pawn::pushes<Color::White>(pawn, white_king | black_king) & ~Bitboard::rank_8};
+    for (const Bitboard to : pawn_pushes.iterate()) {
+      move_results |= results[to_index(false, white_king, black_king, to)];
+    }
+
+    if (move_results & Win) return Win;
+    if (move_results & Unknown) return Unknown;
+    return Draw;
+  } else {
+    for (const Bitboard to : King::attacks(black_king).iterate()) {
+      move_results |= results[to_index(true, white_king, to, pawn)];
+    }
+
+    if (move_results & Draw) return Draw;
+    if (move_results & Unknown) return Unknown;
+    return Win;
+  }
+}
+
+class Bitbase {
+public:
+  Bitbase();
+
+  bool is_win(size_t index) const { return wins[index / 64] >> (index % 64) & 1; }
+
+private:
+  std::array<uint64_t, position_count / 64> wins{};
+};
+
+Bitbase::Bitbase() {
+  std::vector<Position> positions;
+  positions.reserve(position_count);
+  std::vector<Result> results(position_count, Invalid);
+  const Bitboard pawn_squares{(Bitboard::rank_2 | Bitboard::rank_3 | Bitboard::rank_4 | Bitboard::rank_5 |
+                               Bitboard::rank_6 | Bitboard::rank_7) &
+                              (Bitboard::file_A | Bitboard::file_B | Bitboard::file_C | Bitboard::file_D)};
+  for (const Bitboard pawn : pawn_squares.iterate()) {
+    for (int white_king{0}; white_king < 64; white_king++) {
+      for (int black_king{0}; black_king < 64; black_king++) {
+        for (const bool is_white_turn : {true, false}) {
+          const Position position{is_white_turn, Bitboard::from_index(white_king), Bitboard::from_index(black_king),
+                                  pawn};
+          const Result result{get_initial_result(position)};
+          results[to_index(is_white_turn, position.white_king, position.black_king, pawn)] = result;
+          if (result == Unknown) positions.push_back(position);
+        }
+      }
+    }
+  }
+
+  // Repeatedly resolve the unknown positions until no more can be resolved. The remaining positions are draws, as
+  // white cannot force a win from them.
+  bool has_changed{true};
+  while (has_changed) {
+    has_changed = false;
+    for (const Position& position : positions) {
+      const auto& [is_white_turn, white_king, black_king, pawn] = position;
+      Result& result{results[to_index(is_white_turn, white_king, black_king, pawn)]};
+      if (result != Unknown) continue;
+      result = get_result(position, results);
+      if (result != Unknown) has_changed = true;
+    }
+  }
+
+  for (size_t index{0}; index < position_count; index++) {
+    if (results[index] == Win) wins[index / 64] |= uint64_t{1} << (index % 64);
+  }
+}
+
+// Returns the bitbase, which is generated the first time this is called.
+const Bitbase& get_bitbase() {
+  static const Bitbase bitbase{};
+  return bitbase;
+}
+}  // namespace
+
+std::optional<bool> kpk::probe(const Board& board) {
+  const Player& white{board.get_player<Color::White>()};
+  const Player& black{board.get_player<Color::Black>()};
+  const Bitboard occupied{white.occupied() | black.occupied()};
+  if (occupied.count() != 3) return std::nullopt;
+  const bool is_white_strong{static_cast<bool>(white[PieceType::Pawn])};
+  if (!is_white_strong && !black[PieceType::Pawn]) return std::nullopt;
+
+  const Player& strong{is_white_strong ? white : black};
+  const Player& weak{is_white_strong ? black : white};
+  int strong_king{strong[PieceType::King].to_index()};
+  int weak_king{weak[PieceType::King].to_index()};
+  int pawn{strong[PieceType::Pawn].to_index()};
+  // Flip the board vertically if black has the pawn, and horizontally if the pawn is on files E to H.
+  const int flip{(is_white_strong ? 0 : 56) ^ (pawn % 8 >= 4 ? 7 : 0)};
+  strong_king ^= flip;
+  weak_king ^= flip;
+  pawn ^= flip;
+
+  const bool is_strong_turn{board.is_white_to_move() == is_white_strong};
+  return get_bitbase().is_win(to_index(is_strong_turn, Bitboard::from_index(strong_king),
+                                       Bitboard::from_index(weak_king), Bitboard::from_index(pawn)));
+}
+
+void kpk::init() { get_bitbase(); }
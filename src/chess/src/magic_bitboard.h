@@ -2,15 +2,28 @@
 
 #include <algorithm>
 #include <array>
-#include <vector>
+#include <bit>
+#include <cstddef>
 
 #include "bitboard.h"
 
 using namespace chess;
 
+// Returns the number of entries needed by a magic bitboard with the given shifts.
+constexpr size_t magic_bitboard_size(const std::array<int, 64>& shifts);
+
+// Calls `callback(index, occupancy, attacks)` for each square index, and each subset `occupancy` of that square's mask
+// (in increasing order), with the attacks of a slider that moves in the given directions.
+template <typename Callback>
+constexpr void for_each_slider_attack(const std::array<std::pair<int, int>, 4>& directions,
+                                      const std::array<Bitboard, 64>& masks, Callback callback);
+
 // Fast lookup of sliding piece attacks.
 // Shift, masks and magics should be generated by tools/magic_calculator.cpp
 // Details here: https://www.chessprogramming.org/Magic_Bitboards
+// The attacks of all squares are stored in one flat array (with per-square offsets), which is computed at compile time.
+// `Size` must be `magic_bitboard_size(shifts)`.
+template <size_t Size>
 class MagicBitboard {
 public:
   // Note that `masks_` is an array of `uint64_t` instead of `Bitboard`, to maintain compatibility
@@ -26,45 +39,93 @@ private:
   std::array<int, 64> shifts;
   std::array<Bitboard, 64> masks;
   std::array<uint64_t, 64> magics;
-  std::vector<Bitboard> moves[64];
+  std::array<uint32_t, 64> offsets;  // Offset of each square's attacks in `moves`.
+  alignas(64) std::array<Bitboard, Size> moves;
 
   // Precompute the moves bitboard for each square.
   constexpr void precompute();
 };
 
-constexpr MagicBitboard::MagicBitboard(std::array<std::pair<int, int>, 4> directions, std::array<int, 64> shifts,
-                                       std::array<uint64_t, 64> masks_, std::array<uint64_t, 64> magics)
-    : directions{directions}, shifts{shifts}, magics{magics} {
+// ========== IMPLEMENTATIONS ==========
+
+constexpr size_t magic_bitboard_size(const std::array<int, 64>& shifts) {
+  size_t size{0};
+  for (const int shift : shifts) size += size_t{1} << (64 - shift);
+  return size;
+}
+
+template <size_t Size>
+constexpr MagicBitboard<Size>::MagicBitboard(std::array<std::pair<int, int>, 4> directions, std::array<int, 64> shifts,
+                                             std::array<uint64_t, 64> masks_, std::array<uint64_t, 64> magics)
+    : directions{directions}, shifts{shifts}, masks{}, magics{magics}, offsets{}, moves{} {
   std::transform(masks_.begin(), masks_.end(), masks.begin(), [](uint64_t mask) { return Bitboard{mask}; });
-  for (int i = 0; i < 64; i++) moves[i].resize(1 << (64 - shifts[i]));
+  uint32_t offset{0};
+  for (int i = 0; i < 64; i++) {
+    offsets[i] = offset;
+    offset += uint32_t{1} << (64 - shifts[i]);
+  }
   precompute();
 }
 
-constexpr Bitboard MagicBitboard::attacks(Bitboard bit, Bitboard occupancy) const {
+template <size_t Size>
+constexpr Bitboard MagicBitboard<Size>::attacks(Bitboard bit, Bitboard occupancy) const {
   int index{bit.to_index()};
   uint64_t hash = (static_cast<uint64_t>(occupancy & masks[index]) * magics[index]) >> shifts[index];
-  return moves[index][hash];
+  return moves[offsets[index] + hash];
 };
 
-constexpr void MagicBitboard::precompute() {
+template <size_t Size>
+constexpr void MagicBitboard<Size>::precompute() {
+  // Raw pointers are used as they are evaluated faster at compile time.
+  Bitboard* const moves_data{moves.data()};
+  const uint32_t* const offsets_data{offsets.data()};
+  const uint64_t* const magics_data{magics.data()};
+  const int* const shifts_data{shifts.data()};
+  for_each_slider_attack(directions, masks, [&](int index, uint64_t occupancy, uint64_t attacks) {
+    moves_data[offsets_data[index] + ((occupancy * magics_data[index]) >> shifts_data[index])] = Bitboard{attacks};
+  });
+}
+
+template <typename Callback>
+constexpr void for_each_slider_attack(const std::array<std::pair<int, int>, 4>& directions,
+                                      const std::array<Bitboard, 64>& masks, Callback callback) {
+  // As this runs at compile time, the loops below work on raw integers and arrays, which the compiler evaluates much
+  // faster than the equivalent Bitboard operations.
+
+  // rays[index][i] is the ray from the square of the given index in directions[i] (excluding the square itself).
+  uint64_t rays[64][4]{};
   for (int index = 0; index < 64; index++) {
-    int y = index / 8;
-    int x = index % 8;
-    for (const Bitboard occupancy : masks[index].iterate_subsets()) {
-      Bitboard move_bitmap{0};
-      for (auto [delta_y, delta_x] : directions) {
-        int to_y = y + delta_y;
-        int to_x = x + delta_x;
-        while (0 <= to_y && to_y < 8 && 0 <= to_x && to_x < 8) {
-          Bitboard to_bit{Bitboard::from_coordinate(to_y, to_x)};
-          move_bitmap ^= to_bit;
-          if (to_bit & occupancy) break;
-          to_y += delta_y;
-          to_x += delta_x;
-        }
+    for (int i = 0; i < 4; i++) {
+      const auto [delta_y, delta_x] = directions[i];
+      int to_y = index / 8 + delta_y;
+      int to_x = index % 8 + delta_x;
+      while (0 <= to_y && to_y < 8 && 0 <= to_x && to_x < 8) {
+        rays[index][i] |= uint64_t{1} << (to_y * 8 + to_x);
+        to_y += delta_y;
+        to_x += delta_x;
       }
-      uint64_t hash = (static_cast<uint64_t>(occupancy) * magics[index]) >> shifts[index];
-      moves[index][hash] = move_bitmap;
     }
   }
-}
\ No newline at end of file
+  bool is_increasing[4]{};
+  for (int i = 0; i < 4; i++) is_increasing[i] = directions[i].first * 8 + directions[i].second > 0;
+
+  // The attacks along a ray stop at the nearest blocker, so they are the ray minus the blocker's ray.
+  for (int index = 0; index < 64; index++) {
+    const uint64_t mask{static_cast<uint64_t>(masks[index])};
+    uint64_t occupancy{0};
+    do {  // Traverse the subsets in increasing order (https://www.chessprogramming.org/Traversing_Subsets_of_a_Set).
+      uint64_t attacks{0};
+      for (int i = 0; i < 4; i++) {
+        const uint64_t blockers{rays[index][i] & occupancy};
+        if (!blockers) {
+          attacks |= rays[index][i];
+          continue;
+        }
+        const int blocker_index{is_increasing[i] ? std::countr_zero(blockers) : 63 - std::countl_zero(blockers)};
+        attacks |= rays[index][i] ^ rays[blocker_index][i];
+      }
+      callback(index, occupancy, attacks);
+      occupancy = (occupancy - mask) & mask;
+    } while (occupancy);
+  }
+}
@@ -0,0 +1,48 @@
+#include "mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+using namespace chess;
+
+MappedFile::MappedFile(const std::filesystem::path& path, Access access) : data{nullptr}, size{0} {
+  const int fd{::open(path.c_str(), O_RDONLY)};
+  if (fd < 0) throw std::runtime_error{"Failed to open " + path.string()};
+  struct stat file_stat;
+  if (::fstat(fd, &file_stat) != 0) {
+    ::close(fd);
+    throw std::runtime_error{"Failed to read the size of " + path.string()};
+  }
+  size = static_cast<size_t>(file_stat.st_size);
+
+  // An empty file cannot be mapped, but it has no contents anyway.
+  if (size > 0) {
+    void* const mapping{::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0)};
+    if (mapping == MAP_FAILED) {
+      ::close(fd);
+      throw std::runtime_error{"Failed to map " + path.string()};
+    }
+    ::madvise(mapping, size, access == Access::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+    data = static_cast<const char*>(mapping);
+  }
+  ::close(fd);  // The mapping remains valid after closing the file.
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data{std::exchange(other.data, nullptr)}, size{std::exchange(other.size, 0)} {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  std::swap(data, other.data);
+  std::swap(size, other.size);
+  return *this;
+}
+
+MappedFile::~MappedFile() {
+  if (data) ::munmap(const_cast<char*>(data), size);
+}
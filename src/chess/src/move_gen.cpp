@@ -1,32 +1,137 @@
 #include "move_gen.h"
 
+#include <algorithm>
 #include <array>
 
 #include "bitboard.h"
+#include "board_info.h"
+#include "constants.h"
 #include "piece.h"
 #include "pieces/base_piece.h"
 
 using namespace chess;
 
+namespace {
+// The visitors below consume the moves generated by MoveGen. MoveGen is templated on the visitor so that its calls are
+// inlined, and it passes the moves of a piece as a bitboard of destination squares so that visitors which only count
+// moves never construct them.
+
+// Adds the visited moves to a MoveContainer.
+class MoveAdder {
+public:
+  MoveAdder(const Board& board, MoveContainer& moves) : board{board}, moves{moves} {}
+
+  // Adds the moves of the `PT` on `from` to each square of `tos`, accounting for promotions and captures.
+  template <PieceType PT>
+  void add_moves(Bitboard from, Bitboard tos) {
+    for (const Bitboard to : tos.iterate()) {
+      const PieceType captured_piece{board.piece_at(to)};
+      if constexpr (PT == PieceType::Pawn) {
+        if (to & (Bitboard::rank_1 | Bitboard::rank_8)) {
+          moves.push_back(Move::promotion(from, to, PieceType::Bishop, captured_piece));
+          moves.push_back(Move::promotion(from, to, PieceType::Knight, captured_piece));
+          moves.push_back(Move::promotion(from, to, PieceType::Queen, captured_piece));
+          moves.push_back(Move::promotion(from, to, PieceType::Rook, captured_piece));
+          continue;
+        }
+      }
+      moves.push_back(Move::move(from, to, PT, captured_piece));
+    }
+  }
+
+  // Adds the en passant capture of the pawn on `from` that moves to `to`.
+  void add_en_passant(Bitboard from, Bitboard to) {
+    moves.push_back(Move::move(from, to, PieceType::Pawn, PieceType::Pawn));
+  }
+
+private:
+  const Board& board;
+  MoveContainer& moves;
+};
+
+// Counts the visited moves without constructing them.
+class MoveCounter {
+public:
+  template <PieceType PT>
+  void add_moves(Bitboard /* from */, Bitboard tos) {
+    count += tos.count();
+    // Each promotion square is reached by 4 moves.
+    if constexpr (PT == PieceType::Pawn) count += 3 * (tos & (Bitboard::rank_1 | Bitboard::rank_8)).count();
+  }
+
+  void add_en_passant(Bitboard /* from */, Bitboard /* to */) { count++; }
+
+  size_t get_count() const { return count; }
+
+private:
+  size_t count{0};
+};
+
+// Looks for a given move among the visited moves, without constructing the others.
+class MoveFinder {
+public:
+  MoveFinder(const Board& board, const Move& move) : board{board}, move{move} {}
+
+  template <PieceType PT>
+  void add_moves(Bitboard from, Bitboard tos) {
+    if (PT != move.get_piece() || from != move.get_from() || !(tos & move.get_to())) return;
+    const Bitboard to{move.get_to()};
+    const PieceType captured_piece{board.piece_at(to)};
+    if constexpr (PT == PieceType::Pawn) {
+      if (to & (Bitboard::rank_1 | Bitboard::rank_8)) {
+        for (const PieceType promotion_piece :
+             {PieceType::Bishop, PieceType::Knight, PieceType::Queen, PieceType::Rook}) {
+          found |= move == Move::promotion(from, to, promotion_piece, captured_piece);
+        }
+        return;
+      }
+    }
+    found |= move == Move::move(from, to, PT, captured_piece);
+  }
+
+  void add_en_passant(Bitboard from, Bitboard to) {
+    found |= move == Move::move(from, to, PieceType::Pawn, PieceType::Pawn);
+  }
+
+  bool is_found() const { return found; }
+
+private:
+  const Board& board;
+  const Move& move;
+  bool found{false};
+};
+}  // namespace
+
 template <Color PlayerColor>
 class MoveGen {
 public:
-  MoveGen(const Board& board);
+  MoveGen(const BoardInfo& info);
+
+  // Generate all legal moves into `visitor`.
+  template <typename Visitor>
+  void generate_moves(Visitor& visitor) const;
 
-  // Generate a list of all legal moves.
-  MoveContainer generate_moves() const;
+  // Generate all legal captures and promotions into `visitor`.
+  template <typename Visitor>
+  void generate_quiescence_moves(Visitor& visitor) const;
 
-  // Generate a list of all legal captures and promotions.
-  MoveContainer generate_quiescence_moves() const;
+  // Generate all legal captures, checks and promotions into `visitor`.
+  template <typename Visitor>
+  void generate_quiescence_moves_and_checks(Visitor& visitor) const;
 
-  // Generate a list of all legal captures, checks and promotions.
-  MoveContainer generate_quiescence_moves_and_checks() const;
+  // Generate all legal moves that are neither captures nor promotions into `visitor`, given that the king is not in
+  // check.
+  template <typename Visitor>
+  void generate_quiet_moves(Visitor& visitor) const;
 
   // Returns true if the current player still has any move to make.
   bool has_moves() const;
 
-  // Check if the given square is under attack by the opponent.
-  bool is_under_attack(Bitboard square) const;
+  // Returns true if the current player is in check.
+  bool is_in_check() const;
+
+  // Returns true if the given move is legal.
+  bool is_legal(const Move& move) const;
 
 private:
   const Board& board;
@@ -35,55 +140,39 @@ private:
   const Bitboard cur_occupied;
   const Bitboard opp_occupied;
   const Bitboard total_occupied;
-  const std::array<Bitboard, 3> opp_piece_at;
-  const Bitboard king_bishop_rays;
-  const Bitboard king_rook_rays;
-  const Bitboard pinners;        // Opp pieces that pin my pieces to my king.
-  const Bitboard pinned_pieces;  // My pieces that are pinned to my king.
+  const Bitboard king_attackers;  // Opp pieces that attack my king.
+  const Bitboard pinners;         // Opp pieces that pin my pieces to my king.
+  const Bitboard pinned_pieces;   // My pieces that are pinned to my king.
+  const Bitboard opp_attacks;     // Squares that my king cannot move to.
 
-  // Returns a bitboard of opp pieces that are pinning any of my pieces to my king. To be called during initialization.
-  Bitboard compute_pinners() const;
-  // Returns a bitboard of my pieces that are pinned to my king. To be called during initialization.
-  Bitboard compute_pinned_pieces() const;
-
-  // Returns a bitboard of opponent pieces that attack the king.
-  Bitboard get_king_attackers() const;
-
-  // Gets the opponent piece at the given square.
+  // Gets the opponent piece at the given square, which must not contain a piece of the current player.
   PieceType get_opp_piece_at(Bitboard bit) const;
 
   // Returns a bitboard of squares that a piece on the given square can move to (not accounting for legality).
   template <PieceType PT>
   Bitboard get_piece_moves(Bitboard square) const;
 
-  // Returns a bitboard of squares that a piece on the given square can attack.
-  template <PieceType PT>
-  Bitboard get_piece_attacks(Bitboard square) const;
-
   // Returns a bitboard of squares that a opponent piece on the given square can attack.
   template <PieceType PT>
   Bitboard get_opp_piece_attacks(Bitboard square) const;
 
-  // Adds a move to the container, accounting for promotions and captures.
-  template <PieceType PT>
-  void add_move(MoveContainer& moves, Bitboard from, Bitboard to) const;
-
-  enum class MoveType { All, CapturesAndPromotionsOnly, CapturesChecksAndPromotionsOnly };
+  enum class MoveType { All, CapturesAndPromotionsOnly, CapturesChecksAndPromotionsOnly, QuietsOnly };
 
-  // Generate legal moves of the piece, given that the king is not in check.
-  template <PieceType PT, MoveType MT>
-  void generate_unchecked_piece_moves(MoveContainer& moves) const;
+  // Generate legal moves of the piece (only those from `from_mask`), given that the king is not in check.
+  template <PieceType PT, MoveType MT, typename Visitor>
+  void generate_unchecked_piece_moves(Visitor& visitor, Bitboard from_mask = Bitboard::full) const;
 
   // Generate legal king moves given that the king is not in check.
-  template <MoveType MT>
-  void generate_unchecked_king_moves(MoveContainer& moves) const;
+  template <MoveType MT, typename Visitor>
+  void generate_unchecked_king_moves(Visitor& visitor) const;
 
   // Generate legal king moves that escape the single-check.
-  void generate_king_single_check_evasions(MoveContainer& moves, Bitboard attacker) const;
+  template <typename Visitor>
+  void generate_king_single_check_evasions(Visitor& visitor, Bitboard attacker) const;
 
   // Generate legal king moves that escape the double-check.
-  template <MoveType MT>
-  void generate_king_double_check_evasions(MoveContainer& moves) const;
+  template <MoveType MT, typename Visitor>
+  void generate_king_double_check_evasions(Visitor& visitor) const;
 
   // Check if there are legal moves for this piece given that the king is not in check.
   template <PieceType PT>
@@ -99,68 +188,52 @@ private:
   bool has_king_double_check_evasions() const;
 };
 
-std::array<Bitboard, 3> compute_piece_at(const Player& player) {
-  std::array<Bitboard, 3> piece_at{};
-  // All the piece bitboards are compressed into 3 bitboards, where piece_at[i] represents whether the ith bit is set
-  // for the piece at each square.
-  const Bitboard none_bitboard = Bitboard::full & ~(player.occupied());
-  piece_at[0] =
-      player[static_cast<PieceType>(1)] | player[static_cast<PieceType>(3)] | player[static_cast<PieceType>(5)];
-  piece_at[1] = player[static_cast<PieceType>(2)] | player[static_cast<PieceType>(3)] | none_bitboard;
-  piece_at[2] = player[static_cast<PieceType>(4)] | player[static_cast<PieceType>(5)] | none_bitboard;
-  return piece_at;
-}
-
 template <Color PlayerColor>
-MoveGen<PlayerColor>::MoveGen(const Board& board)
-    : board{board},
+MoveGen<PlayerColor>::MoveGen(const BoardInfo& info)
+    : board{info.get_board()},
       cur_player{board.get_player<PlayerColor>()},
       opp_player{board.get_player<PlayerColor.flip()>()},
       cur_occupied{cur_player.occupied()},
       opp_occupied{opp_player.occupied()},
       total_occupied{cur_occupied | opp_occupied},
-      opp_piece_at{compute_piece_at(opp_player)},
-      king_bishop_rays{Bishop::attacks(cur_player[PieceType::King], total_occupied)},
-      king_rook_rays{Rook::attacks(cur_player[PieceType::King], total_occupied)},
-      pinners{compute_pinners()},
-      pinned_pieces{compute_pinned_pieces()} {}
+      king_attackers{info.get_checkers()},
+      pinners{info.get_pinners()},
+      pinned_pieces{info.get_pinned_pieces()},
+      opp_attacks{info.get_opp_attacks()} {}
 
 template <Color PlayerColor>
-MoveContainer MoveGen<PlayerColor>::generate_moves() const {
-  MoveContainer moves;
-  Bitboard king_attackers = get_king_attackers();
+template <typename Visitor>
+void MoveGen<PlayerColor>::generate_moves(Visitor& visitor) const {
   if (!king_attackers) {
     // King is not in check.
     piece::visit_non_king_pieces(
-        [this, &moves]<PieceType PT>() { this->generate_unchecked_piece_moves<PT, MoveType::All>(moves); });
-    generate_unchecked_king_moves<MoveType::All>(moves);
+        [this, &visitor]<PieceType PT>() { this->generate_unchecked_piece_moves<PT, MoveType::All>(visitor); });
+    generate_unchecked_king_moves<MoveType::All>(visitor);
   } else if (king_attackers.count() == 1) {
     // King is in single-check.
-    generate_king_single_check_evasions(moves, king_attackers);
+    generate_king_single_check_evasions(visitor, king_attackers);
   } else {
     // King is in double-check.
-    generate_king_double_check_evasions<MoveType::All>(moves);
+    generate_king_double_check_evasions<MoveType::All>(visitor);
   }
-  return moves;
 }
 
 template <Color PlayerColor>
-MoveContainer MoveGen<PlayerColor>::generate_quiescence_moves() const {
-  MoveContainer moves;
-  piece::visit_non_king_pieces([this, &moves]<PieceType PT>() {
-    this->generate_unchecked_piece_moves<PT, MoveType::CapturesAndPromotionsOnly>(moves);
+template <typename Visitor>
+void MoveGen<PlayerColor>::generate_quiescence_moves(Visitor& visitor) const {
+  piece::visit_non_king_pieces([this, &visitor]<PieceType PT>() {
+    this->generate_unchecked_piece_moves<PT, MoveType::CapturesAndPromotionsOnly>(visitor);
   });
-  generate_unchecked_king_moves<MoveType::CapturesAndPromotionsOnly>(moves);
-  return moves;
+  generate_unchecked_king_moves<MoveType::CapturesAndPromotionsOnly>(visitor);
 }
 
 template <Color PlayerColor>
-MoveContainer MoveGen<PlayerColor>::generate_quiescence_moves_and_checks() const {
-  MoveContainer moves;
-  piece::visit_non_king_pieces([this, &moves]<PieceType PT>() {
-    this->generate_unchecked_piece_moves<PT, MoveType::CapturesChecksAndPromotionsOnly>(moves);
+template <typename Visitor>
+void MoveGen<PlayerColor>::generate_quiescence_moves_and_checks(Visitor& visitor) const {
+  piece::visit_non_king_pieces([this, &visitor]<PieceType PT>() {
+    this->generate_unchecked_piece_moves<PT, MoveType::CapturesChecksAndPromotionsOnly>(visitor);
   });
-  generate_unchecked_king_moves<MoveType::CapturesChecksAndPromotionsOnly>(moves);
+  generate_unchecked_king_moves<MoveType::CapturesChecksAndPromotionsOnly>(visitor);
 
   // The move generation above can only generate checks where the piece moved is the one giving check.
   // Another type of check is where the piece moves and another piece is the one giving check, which we generate below.
@@ -168,19 +241,15 @@ MoveContainer MoveGen<PlayerColor>::generate_quiescence_moves_and_checks() const
   // The piece at `from`, if moved to anywhere in `to_mask`, will cause a check by another piece.
   // Note that captures and promotions are ignored, as they are generated above already.
   auto generate_indirect_checks = [&](const Bitboard from, Bitboard to_mask) {
-    const PieceType piece = cur_player.piece_at(from);
     if (pinned_pieces & from) to_mask &= cur_player[PieceType::King].ray(from);  // Constrain to pin ray.
     to_mask &= ~total_occupied;                                                  // Remove captures.
-    piece::visit(piece, [this, from, &to_mask]<PieceType PT>() {
-      to_mask &= get_piece_moves<PT>(from);  // Constrain to squares this piece can move to.
-      to_mask &= ~get_opp_piece_attacks<PT>(opp_player[PieceType::King]);  // Remove checks.
+    piece::visit(board.piece_at(from), [this, &visitor, from, to_mask]<PieceType PT>() {
+      Bitboard tos{to_mask & get_piece_moves<PT>(from)};  // Constrain to squares this piece can move to.
+      tos &= ~get_opp_piece_attacks<PT>(opp_player[PieceType::King]);  // Remove checks.
+      if constexpr (PT == PieceType::Pawn) tos &= ~Pawn::get_promotion_squares<PlayerColor>();  // Remove promotions.
+      if constexpr (PT == PieceType::King) tos &= ~opp_attacks;  // Stop king from moving into check.
+      visitor.template add_moves<PT>(from, tos);
     });
-    if (piece == PieceType::Pawn) to_mask &= ~Pawn::get_promotion_squares<PlayerColor>();  // Remove promotions.
-
-    for (const Bitboard to : to_mask.iterate()) {
-      if (piece == PieceType::King && is_under_attack(to)) continue;  // Stop king from moving into check.
-      moves.push_back(Move::move(from, to, piece, get_opp_piece_at(to)));
-    }
   };
 
   const Bitboard opp_king = opp_player[PieceType::King];
@@ -201,13 +270,18 @@ MoveContainer MoveGen<PlayerColor>::generate_quiescence_moves_and_checks() const
     const Bitboard blocker{between_bishop_and_opp_king & bishop_ray_blockers};
     generate_indirect_checks(blocker, ~between_bishop_and_opp_king);
   }
+}
 
-  return moves;
+template <Color PlayerColor>
+template <typename Visitor>
+void MoveGen<PlayerColor>::generate_quiet_moves(Visitor& visitor) const {
+  piece::visit_non_king_pieces(
+      [this, &visitor]<PieceType PT>() { this->generate_unchecked_piece_moves<PT, MoveType::QuietsOnly>(visitor); });
+  generate_unchecked_king_moves<MoveType::QuietsOnly>(visitor);
 }
 
 template <Color PlayerColor>
 bool MoveGen<PlayerColor>::has_moves() const {
-  Bitboard king_attackers = get_king_attackers();
   if (!king_attackers) {
     // King is not in check.
     // Note that queen moves are checked in both has_unchecked_bishoplike_moves()
@@ -228,54 +302,30 @@ bool MoveGen<PlayerColor>::has_moves() const {
 }
 
 template <Color PlayerColor>
-bool MoveGen<PlayerColor>::is_under_attack(Bitboard square) const {
-  const auto is_attacked_by = [this, square]<PieceType PT>() {
-    return static_cast<bool>(get_piece_attacks<PT>(square) & opp_player[PT]);
-  };
-  bool is_attacked{false};
-  piece::visit_all_pieces([&is_attacked, &is_attacked_by]<PieceType PT>() {
-    if (is_attacked) return;
-    is_attacked |= is_attacked_by.template operator()<PT>();
-  });
-  return is_attacked;
-}
-
-template <Color PlayerColor>
-Bitboard MoveGen<PlayerColor>::compute_pinners() const {
-  // NOTE: This function is called during initialization, not all members might be
-  // initialized yet!
-  const Bitboard current_slider_attackers =
-      (king_bishop_rays & (opp_player[PieceType::Bishop] | opp_player[PieceType::Queen])) |
-      (king_rook_rays & (opp_player[PieceType::Rook] | opp_player[PieceType::Queen]));
-  const Bitboard potential_pinned_pieces = (king_bishop_rays | king_rook_rays) & cur_occupied;
-  const Bitboard new_slider_attackers =
-      (Bishop::attacks(cur_player[PieceType::King], total_occupied ^ potential_pinned_pieces) &
-       (opp_player[PieceType::Bishop] | opp_player[PieceType::Queen])) |
-      (Rook::attacks(cur_player[PieceType::King], total_occupied ^ potential_pinned_pieces) &
-       (opp_player[PieceType::Rook] | opp_player[PieceType::Queen]));
-  return new_slider_attackers ^ current_slider_attackers;
+bool MoveGen<PlayerColor>::is_in_check() const {
+  return static_cast<bool>(king_attackers);
 }
 
 template <Color PlayerColor>
-Bitboard MoveGen<PlayerColor>::compute_pinned_pieces() const {
-  // NOTE: This function is called during initialization, not all members might be
-  // initialized yet!
-  Bitboard pinned_pieces{Bitboard::empty};
-  for (const Bitboard pinner : pinners.iterate()) {
-    const Bitboard pinned_piece = cur_player[PieceType::King].until(pinner) & cur_occupied;
-    pinned_pieces ^= pinned_piece;
+bool MoveGen<PlayerColor>::is_legal(const Move& move) const {
+  // Reject moves that do not match the pieces on the board (e.g. moves that were found in another position).
+  if (move.is_null() || move.get_piece() == PieceType::None) return false;
+  if (!(cur_player[move.get_piece()] & move.get_from())) return false;
+
+  // Generate the legal moves of the moved piece only, and look for the given move among them.
+  MoveFinder finder{board, move};
+  if (is_in_check()) {
+    generate_moves(finder);
+  } else if (move.get_piece() == PieceType::King) {
+    generate_unchecked_king_moves<MoveType::All>(finder);
+  } else {
+    piece::visit(move.get_piece(), [this, &finder, &move]<PieceType PT>() {
+      if constexpr (PT != PieceType::King) {
+        this->generate_unchecked_piece_moves<PT, MoveType::All>(finder, move.get_from());
+      }
+    });
   }
-  return pinned_pieces;
-}
-
-template <Color PlayerColor>
-Bitboard MoveGen<PlayerColor>::get_king_attackers() const {
-  Bitboard king = cur_player[PieceType::King];
-  Bitboard attackers = (king_bishop_rays & (opp_player[PieceType::Bishop] | opp_player[PieceType::Queen])) |
-                       (Knight::attacks(king) & opp_player[PieceType::Knight]) |
-                       (Pawn::attacks<PlayerColor>(king) & opp_player[PieceType::Pawn]) |
-                       (king_rook_rays & (opp_player[PieceType::Rook] | opp_player[PieceType::Queen]));
-  return attackers;
+  return finder.is_found();
 }
 
 template <Color PlayerColor>
@@ -292,18 +342,6 @@ Bitboard MoveGen<PlayerColor>::get_piece_moves(Bitboard square) const {
   }
 }
 
-template <Color PlayerColor>
-template <PieceType PT>
-Bitboard MoveGen<PlayerColor>::get_piece_attacks(Bitboard square) const {
-  if constexpr (Piece<PT>::is_slider()) {
-    return Piece<PT>::attacks(square, total_occupied);
-  } else if constexpr (PT == PieceType::Pawn) {
-    return Pawn::attacks<PlayerColor>(square);
-  } else {
-    return Piece<PT>::attacks(square);
-  }
-}
-
 template <Color PlayerColor>
 template <PieceType PT>
 Bitboard MoveGen<PlayerColor>::get_opp_piece_attacks(Bitboard square) const {
@@ -316,34 +354,14 @@ Bitboard MoveGen<PlayerColor>::get_opp_piece_attacks(Bitboard square) const {
   }
 }
 
-template <Color PlayerColor>
-template <PieceType PT>
-void MoveGen<PlayerColor>::add_move(MoveContainer& moves, Bitboard from, Bitboard to) const {
-  const PieceType captured_piece{get_opp_piece_at(to)};
-  if constexpr (PT == PieceType::Pawn) {
-    if (to & Pawn::get_promotion_squares<PlayerColor>()) {
-      moves.push_back(Move::promotion(from, to, PieceType::Bishop, captured_piece));
-      moves.push_back(Move::promotion(from, to, PieceType::Knight, captured_piece));
-      moves.push_back(Move::promotion(from, to, PieceType::Queen, captured_piece));
-      moves.push_back(Move::promotion(from, to, PieceType::Rook, captured_piece));
-      return;
-    }
-  }
-  moves.push_back(Move::move(from, to, PT, captured_piece));
-}
-
 template <Color PlayerColor>
 PieceType MoveGen<PlayerColor>::get_opp_piece_at(Bitboard bit) const {
-  int index{bit.to_index()};
-  int piece = (static_cast<uint64_t>(opp_piece_at[0] >> index) & 1) +
-              ((static_cast<uint64_t>(opp_piece_at[1] >> index) & 1) << 1) +
-              ((static_cast<uint64_t>(opp_piece_at[2] >> index) & 1) << 2);
-  return static_cast<PieceType>(piece);
+  return board.piece_at(bit);
 }
 
 template <Color PlayerColor>
-template <PieceType PT, typename MoveGen<PlayerColor>::MoveType MT>
-void MoveGen<PlayerColor>::generate_unchecked_piece_moves(MoveContainer& moves) const {
+template <PieceType PT, typename MoveGen<PlayerColor>::MoveType MT, typename Visitor>
+void MoveGen<PlayerColor>::generate_unchecked_piece_moves(Visitor& visitor, Bitboard from_mask) const {
   // A piece can only move to certain squares to satisfy MoveType.
   Bitboard to_mask{Bitboard::full};
   if constexpr (MT == MoveType::CapturesAndPromotionsOnly) {
@@ -354,22 +372,26 @@ void MoveGen<PlayerColor>::generate_unchecked_piece_moves(MoveContainer& moves)
     to_mask = opp_occupied | get_opp_piece_attacks<PT>(opp_player[PieceType::King]);
     if constexpr (PT == PieceType::Pawn) to_mask |= Pawn::get_promotion_squares<PlayerColor>();
   }
+  if constexpr (MT == MoveType::QuietsOnly) {
+    to_mask = ~opp_occupied;
+    if constexpr (PT == PieceType::Pawn) to_mask &= ~Pawn::get_promotion_squares<PlayerColor>();
+  }
 
   // Iterate through all pieces of the given type.
-  for (const Bitboard from : cur_player[PT].iterate()) {
+  for (const Bitboard from : (cur_player[PT] & from_mask).iterate()) {
     Bitboard tos{get_piece_moves<PT>(from) & to_mask};
     if (from & pinned_pieces) tos &= cur_player[PieceType::King].ray(from);  // Pinned.
-    for (const Bitboard to : tos.iterate()) add_move<PT>(moves, from, to);
+    visitor.template add_moves<PT>(from, tos);
   }
 
   // Check for en-passant.
   // Note that en-passant cannot be validated by pinned pieces.
   // For example, the case "K..pP..r", where "p" can be captured en-passant, would
   // be wrongly found to be legal.
-  if constexpr (PT == PieceType::Pawn) {
+  if constexpr (PT == PieceType::Pawn && MT != MoveType::QuietsOnly) {
     if (board.get_en_passant()) {
       const Bitboard froms{get_opp_piece_attacks<PieceType::Pawn>(board.get_en_passant()) &
-                           cur_player[PieceType::Pawn]};
+                           cur_player[PieceType::Pawn] & from_mask};
       for (const Bitboard from : froms.iterate()) {
         const Bitboard captured_pawn =
             (PlayerColor == Color::White) ? board.get_en_passant() >> 8 : board.get_en_passant() << 8;
@@ -380,18 +402,18 @@ void MoveGen<PlayerColor>::generate_unchecked_piece_moves(MoveContainer& moves)
         if (Rook::attacks(cur_player[PieceType::King], new_occupied) &
             (opp_player[PieceType::Rook] | opp_player[PieceType::Queen]))
           continue;
-        moves.push_back(Move::move(from, board.get_en_passant(), PieceType::Pawn, PieceType::Pawn));
+        visitor.add_en_passant(from, board.get_en_passant());
       }
     }
   }
 }
 
 template <Color PlayerColor>
-template <typename MoveGen<PlayerColor>::MoveType MT>
-void MoveGen<PlayerColor>::generate_unchecked_king_moves(MoveContainer& moves) const {
+template <typename MoveGen<PlayerColor>::MoveType MT, typename Visitor>
+void MoveGen<PlayerColor>::generate_unchecked_king_moves(Visitor& visitor) const {
   // The king is not in check, hence it either moves to an unattacked square, or
   // we may castle.
-  generate_king_double_check_evasions<MT>(moves);
+  generate_king_double_check_evasions<MT>(visitor);
 
   if constexpr (MT == MoveType::CapturesAndPromotionsOnly) return;
 
@@ -400,29 +422,28 @@ void MoveGen<PlayerColor>::generate_unchecked_king_moves(MoveContainer& moves) c
   if constexpr (MT == MoveType::CapturesChecksAndPromotionsOnly) {
     rook_to_mask = Rook::attacks(opp_player[PieceType::King], total_occupied);
   }
-  if (cur_player.can_castle_kingside() && !(total_occupied & (king << 1 | king << 2)) && !is_under_attack(king << 1) &&
-      !is_under_attack(king << 2) && (rook_to_mask & king << 1)) {
-    moves.push_back(Move::move(king, king << 2, PieceType::King));
+  if (cur_player.can_castle_kingside() && !(total_occupied & (king << 1 | king << 2)) &&
+      !(opp_attacks & (king << 1 | king << 2)) && (rook_to_mask & king << 1)) {
+    visitor.template add_moves<PieceType::King>(king, king << 2);
   }
   if (cur_player.can_castle_queenside() && !(total_occupied & (king >> 1 | king >> 2 | king >> 3)) &&
-      !is_under_attack(king >> 1) && !is_under_attack(king >> 2) && (rook_to_mask & king >> 1)) {
-    moves.push_back(Move::move(king, king >> 2, PieceType::King));
+      !(opp_attacks & (king >> 1 | king >> 2)) && (rook_to_mask & king >> 1)) {
+    visitor.template add_moves<PieceType::King>(king, king >> 2);
   }
 }
 
 template <Color PlayerColor>
-void MoveGen<PlayerColor>::generate_king_single_check_evasions(MoveContainer& moves, Bitboard attacker) const {
+template <typename Visitor>
+void MoveGen<PlayerColor>::generate_king_single_check_evasions(Visitor& visitor, Bitboard attacker) const {
   // To evade a single check, one of the following must be done:
   // 1. Capture the attacker with a piece that is not pinned.
   // 2. King moves to a square that is not attacked.
   // 3. Block the check if it is a sliding check.
 
   // 1. Capture the attacker with a piece that is not pinned.
-  const auto capture_attacker_with_piece{[this, attacker, &moves]<PieceType PT>() {
+  const auto capture_attacker_with_piece{[this, attacker, &visitor]<PieceType PT>() {
     const Bitboard capturers{get_opp_piece_attacks<PT>(attacker) & cur_player[PT] & ~pinned_pieces};
-    for (const Bitboard capturer : capturers.iterate()) {
-      add_move<PT>(moves, capturer, attacker);
-    }
+    for (const Bitboard capturer : capturers.iterate()) visitor.template add_moves<PT>(capturer, attacker);
   }};
   piece::visit_non_king_pieces(capture_attacker_with_piece);
 
@@ -432,24 +453,21 @@ void MoveGen<PlayerColor>::generate_king_single_check_evasions(MoveContainer& mo
     Bitboard pawn_capturers =
         get_opp_piece_attacks<PieceType::Pawn>(capturing_square) & cur_player[PieceType::Pawn] & ~pinned_pieces;
     for (const Bitboard from : pawn_capturers.iterate()) {
-      moves.push_back(Move::move(from, capturing_square, PieceType::Pawn, PieceType::Pawn));
+      visitor.add_en_passant(from, capturing_square);
     }
   }
 
   // 2. King moves to a square that is not attacked. This is the same as evading
   // double check.
-  generate_king_double_check_evasions<MoveType::All>(moves);
+  generate_king_double_check_evasions<MoveType::All>(visitor);
 
   // 3. Block the check if it is a sliding check, with a piece that is not pinned.
   if (piece::is_slider(get_opp_piece_at(attacker))) {
     Bitboard blocking_squares{cur_player[PieceType::King].until(attacker)};
-    const auto block_with_piece{[this, blocking_squares, &moves]<PieceType PT>() {
+    const auto block_with_piece{[this, blocking_squares, &visitor]<PieceType PT>() {
       const Bitboard froms{cur_player[PT] & ~pinned_pieces};
       for (const Bitboard from : froms.iterate()) {
-        const Bitboard tos{get_piece_moves<PT>(from) & blocking_squares};
-        for (const Bitboard to : tos.iterate()) {
-          add_move<PT>(moves, from, to);
-        }
+        visitor.template add_moves<PT>(from, get_piece_moves<PT>(from) & blocking_squares);
       }
     }};
     piece::visit_non_king_pieces(block_with_piece);
@@ -457,24 +475,14 @@ void MoveGen<PlayerColor>::generate_king_single_check_evasions(MoveContainer& mo
 }
 
 template <Color PlayerColor>
-template <typename MoveGen<PlayerColor>::MoveType MT>
-void MoveGen<PlayerColor>::generate_king_double_check_evasions(MoveContainer& moves) const {
+template <typename MoveGen<PlayerColor>::MoveType MT, typename Visitor>
+void MoveGen<PlayerColor>::generate_king_double_check_evasions(Visitor& visitor) const {
   // To evade a double check, the king must move to a square that is not attacked.
   const Bitboard king = cur_player[PieceType::King];
-  Bitboard to_bitboard = King::attacks(king) & ~cur_occupied &
-                         ~Pawn::attacks<PlayerColor.flip()>(opp_player[PieceType::Pawn]) &
-                         ~King::attacks(opp_player[PieceType::King]);
-  if constexpr (MT != MoveType::All) to_bitboard &= opp_occupied;
-  const Bitboard total_occupied_without_king = total_occupied ^ king;
-  for (const Bitboard to : to_bitboard.iterate()) {
-    if (Knight::attacks(to) & opp_player[PieceType::Knight]) continue;
-    if (Bishop::attacks(to, total_occupied_without_king) &
-        (opp_player[PieceType::Bishop] | opp_player[PieceType::Queen]))
-      continue;
-    if (Rook::attacks(to, total_occupied_without_king) & (opp_player[PieceType::Rook] | opp_player[PieceType::Queen]))
-      continue;
-    moves.push_back(Move::move(king, to, PieceType::King, get_opp_piece_at(to)));
-  }
+  Bitboard tos{King::attacks(king) & ~cur_occupied & ~opp_attacks};
+  if constexpr (MT == MoveType::QuietsOnly) tos &= ~opp_occupied;
+  else if constexpr (MT != MoveType::All) tos &= opp_occupied;
+  visitor.template add_moves<PieceType::King>(king, tos);
 }
 
 template <Color PlayerColor>
@@ -520,12 +528,12 @@ bool MoveGen<PlayerColor>::has_unchecked_king_moves() const {
   if (has_king_double_check_evasions()) return true;
 
   const Bitboard king = cur_player[PieceType::King];
-  if (cur_player.can_castle_kingside() && !(total_occupied & (king << 1 | king << 2)) && !is_under_attack(king << 1) &&
-      !is_under_attack(king << 2)) {
+  if (cur_player.can_castle_kingside() && !(total_occupied & (king << 1 | king << 2)) &&
+      !(opp_attacks & (king << 1 | king << 2))) {
     return true;
   }
   if (cur_player.can_castle_queenside() && !(total_occupied & (king >> 1 | king >> 2 | king >> 3)) &&
-      !is_under_attack(king >> 1) && !is_under_attack(king >> 2)) {
+      !(opp_attacks & (king >> 1 | king >> 2))) {
     return true;
   }
 
@@ -583,59 +591,373 @@ bool MoveGen<PlayerColor>::has_king_single_check_evasions(Bitboard attacker) con
 template <Color PlayerColor>
 bool MoveGen<PlayerColor>::has_king_double_check_evasions() const {
   // To evade a double check, the king must move to a square that is not attacked.
-  const Bitboard king = cur_player[PieceType::King];
-  const Bitboard to_bitboard = King::attacks(king) & ~cur_occupied &
-                               ~Pawn::attacks<PlayerColor.flip()>(opp_player[PieceType::Pawn]) &
-                               ~King::attacks(opp_player[PieceType::King]);
-  const Bitboard total_occupied_without_king = total_occupied ^ king;
-  for (const Bitboard to : to_bitboard.iterate()) {
-    if (Knight::attacks(to) & opp_player[PieceType::Knight]) continue;
-    if (Bishop::attacks(to, total_occupied_without_king) &
-        (opp_player[PieceType::Bishop] | opp_player[PieceType::Queen]))
-      continue;
-    if (Rook::attacks(to, total_occupied_without_king) & (opp_player[PieceType::Rook] | opp_player[PieceType::Queen]))
-      continue;
-    return true;
+  return static_cast<bool>(King::attacks(cur_player[PieceType::King]) & ~cur_occupied & ~opp_attacks);
+}
+
+// Generates pseudo-legal moves, which follow the movement rules of each piece but may leave the king in check. Unlike
+// MoveGen, no checks or pins are computed, so the cost of legality is only paid (by `is_legal`) for moves that are
+// actually played.
+template <Color PlayerColor>
+class PseudoLegalMoveGen {
+public:
+  explicit PseudoLegalMoveGen(const Board& board);
+
+  // Generate all pseudo-legal moves (or only captures and promotions if `CapturesAndPromotionsOnly`) into `visitor`.
+  // Castling is only generated when it is legal.
+  template <bool CapturesAndPromotionsOnly, typename Visitor>
+  void generate_moves(Visitor& visitor) const;
+
+  // Returns true if the given pseudo-legal move does not leave the king in check.
+  bool is_legal(const Move& move) const;
+
+private:
+  const Board& board;
+  const Player& cur_player;
+  const Player& opp_player;
+  const Bitboard cur_occupied;
+  const Bitboard opp_occupied;
+  const Bitboard total_occupied;
+
+  // Returns true if the given square is attacked by the opponent, where `occupied` are the squares treated as occupied.
+  bool is_attacked(Bitboard square, Bitboard occupied) const;
+};
+
+template <Color PlayerColor>
+PseudoLegalMoveGen<PlayerColor>::PseudoLegalMoveGen(const Board& board)
+    : board{board},
+      cur_player{board.get_player<PlayerColor>()},
+      opp_player{board.get_player<PlayerColor.flip()>()},
+      cur_occupied{cur_player.occupied()},
+      opp_occupied{opp_player.occupied()},
+      total_occupied{cur_occupied | opp_occupied} {}
+
+template <Color PlayerColor>
+template <bool CapturesAndPromotionsOnly, typename Visitor>
+void PseudoLegalMoveGen<PlayerColor>::generate_moves(Visitor& visitor) const {
+  const Bitboard to_mask{CapturesAndPromotionsOnly ? opp_occupied : ~cur_occupied};
+  piece::visit_non_king_pieces([this, &visitor, to_mask]<PieceType PT>() {
+    for (const Bitboard from : cur_player[PT].iterate()) {
+      if constexpr (PT == PieceType::Pawn) {
+        Bitboard tos{Pawn::attacks<PlayerColor>(from) & opp_occupied};
+        Bitboard pushes{Pawn::pushes<PlayerColor>(from, total_occupied)};
+        if constexpr (CapturesAndPromotionsOnly) pushes &= Pawn::get_promotion_squares<PlayerColor>();
+        visitor.template add_moves<PT>(from, tos | pushes);
+      } else if constexpr (Piece<PT>::is_slider()) {
+        visitor.template add_moves<PT>(from, Piece<PT>::attacks(from, total_occupied) & to_mask);
+      } else {
+        visitor.template add_moves<PT>(from, Piece<PT>::attacks(from) & to_mask);
+      }
+    }
+  });
+
+  const Bitboard en_passant{board.get_en_passant()};
+  if (en_passant) {
+    const Bitboard froms{Pawn::attacks<PlayerColor.flip()>(en_passant) & cur_player[PieceType::Pawn]};
+    for (const Bitboard from : froms.iterate()) visitor.add_en_passant(from, en_passant);
+  }
+
+  const Bitboard king{cur_player[PieceType::King]};
+  visitor.template add_moves<PieceType::King>(king, King::attacks(king) & to_mask);
+  if constexpr (CapturesAndPromotionsOnly) return;
+
+  // The king may not castle out of, through or into check.
+  if (cur_player.can_castle_kingside() && !(total_occupied & (king << 1 | king << 2)) &&
+      !is_attacked(king, total_occupied) && !is_attacked(king << 1, total_occupied) &&
+      !is_attacked(king << 2, total_occupied)) {
+    visitor.template add_moves<PieceType::King>(king, king << 2);
+  }
+  if (cur_player.can_castle_queenside() && !(total_occupied & (king >> 1 | king >> 2 | king >> 3)) &&
+      !is_attacked(king, total_occupied) && !is_attacked(king >> 1, total_occupied) &&
+      !is_attacked(king >> 2, total_occupied)) {
+    visitor.template add_moves<PieceType::King>(king, king >> 2);
   }
-  return false;
 }
 
-MoveContainer move_gen::generate_moves(const Board& board) {
-  if (board.is_white_to_move()) {
-    return MoveGen<Color::White>{board}.generate_moves();
+template <Color PlayerColor>
+bool PseudoLegalMoveGen<PlayerColor>::is_legal(const Move& move) const {
+  const Bitboard from{move.get_from()};
+  const Bitboard to{move.get_to()};
+  if (move.get_piece() == PieceType::King) {
+    if (move.is_castle()) return true;  // Castling is only generated when legal.
+    // Sliders attack through the king's old square.
+    return !is_attacked(to, total_occupied ^ from);
+  }
+
+  // The move is legal if no opponent piece attacks the king once the move is made, other than the captured piece.
+  Bitboard captured{to};
+  if (move.get_piece() == PieceType::Pawn && to == board.get_en_passant()) {
+    captured = PlayerColor == Color::White ? to >> 8 : to << 8;
+  }
+  const Bitboard occupied{(total_occupied ^ from ^ (captured & opp_occupied)) | to};
+  return !(board.attackers_to(cur_player[PieceType::King], occupied) & opp_occupied & ~captured);
+}
+
+template <Color PlayerColor>
+bool PseudoLegalMoveGen<PlayerColor>::is_attacked(Bitboard square, Bitboard occupied) const {
+  return static_cast<bool>(board.attackers_to(square, occupied) & opp_occupied);
+}
+
+MoveContainer move_gen::generate_moves(const Board& board) { return generate_moves(BoardInfo{board}); }
+
+MoveContainer move_gen::generate_moves(const BoardInfo& info) {
+  MoveContainer moves;
+  MoveAdder adder{info.get_board(), moves};
+  if (info.get_board().is_white_to_move()) {
+    MoveGen<Color::White>{info}.generate_moves(adder);
   } else {
-    return MoveGen<Color::Black>{board}.generate_moves();
+    MoveGen<Color::Black>{info}.generate_moves(adder);
   }
+  return moves;
 }
 
 MoveContainer move_gen::generate_quiescence_moves(const Board& board) {
-  if (board.is_white_to_move()) {
-    return MoveGen<Color::White>{board}.generate_quiescence_moves();
+  return generate_quiescence_moves(BoardInfo{board});
+}
+
+MoveContainer move_gen::generate_quiescence_moves(const BoardInfo& info) {
+  MoveContainer moves;
+  MoveAdder adder{info.get_board(), moves};
+  if (info.get_board().is_white_to_move()) {
+    MoveGen<Color::White>{info}.generate_quiescence_moves(adder);
   } else {
-    return MoveGen<Color::Black>{board}.generate_quiescence_moves();
+    MoveGen<Color::Black>{info}.generate_quiescence_moves(adder);
   }
+  return moves;
 }
 
 MoveContainer move_gen::generate_quiescence_moves_and_checks(const Board& board) {
+  return generate_quiescence_moves_and_checks(BoardInfo{board});
+}
+
+MoveContainer move_gen::generate_quiescence_moves_and_checks(const BoardInfo& info) {
+  MoveContainer moves;
+  MoveAdder adder{info.get_board(), moves};
+  if (info.get_board().is_white_to_move()) {
+    MoveGen<Color::White>{info}.generate_quiescence_moves_and_checks(adder);
+  } else {
+    MoveGen<Color::Black>{info}.generate_quiescence_moves_and_checks(adder);
+  }
+  return moves;
+}
+
+size_t move_gen::count_moves(const Board& board) { return count_moves(BoardInfo{board}); }
+
+size_t move_gen::count_moves(const BoardInfo& info) {
+  MoveCounter counter;
+  if (info.get_board().is_white_to_move()) {
+    MoveGen<Color::White>{info}.generate_moves(counter);
+  } else {
+    MoveGen<Color::Black>{info}.generate_moves(counter);
+  }
+  return counter.get_count();
+}
+
+bool move_gen::has_moves(const Board& board) { return has_moves(BoardInfo{board}); }
+
+bool move_gen::has_moves(const BoardInfo& info) {
+  if (info.get_board().is_white_to_move()) {
+    return MoveGen<Color::White>{info}.has_moves();
+  } else {
+    return MoveGen<Color::Black>{info}.has_moves();
+  }
+}
+
+namespace {
+// Returns the score of the game, given that the current player has no legal moves.
+std::optional<int32_t> get_score_without_moves(const BoardInfo& info) {
+  if (!info.is_in_check()) return 0;                   // Stalemate.
+  if (info.get_board().is_white_to_move()) return -1;  // White is checkmated.
+  else return 1;                                       // Black is checkmated.
+}
+}  // namespace
+
+move_gen::MovesAndScore move_gen::generate_moves_and_score(const Board& board) {
+  return generate_moves_and_score(BoardInfo{board});
+}
+
+move_gen::MovesAndScore move_gen::generate_moves_and_score(const BoardInfo& info) {
+  const Board& board{info.get_board()};
+  if (board.get_halfmove_clock() >= constants::fifty_move_rule_plies) return {MoveContainer{}, 0};
+  MovesAndScore result{generate_moves(info), std::nullopt};
+  if (result.moves.empty()) result.score = get_score_without_moves(info);
+  return result;
+}
+
+move_gen::MovesAndScore move_gen::generate_quiescence_moves_and_score(const Board& board) {
+  return generate_quiescence_moves_and_score(BoardInfo{board});
+}
+
+move_gen::MovesAndScore move_gen::generate_quiescence_moves_and_score(const BoardInfo& info) {
+  if (info.is_in_check()) return generate_moves_and_score(info);
+  const Board& board{info.get_board()};
+  if (board.get_halfmove_clock() >= constants::fifty_move_rule_plies) return {MoveContainer{}, 0};
+  MovesAndScore result{generate_quiescence_moves(info), std::nullopt};
+  // Without captures and promotions, the game has only ended if there are no quiet moves either.
+  if (result.moves.empty() && !has_moves(info)) result.score = get_score_without_moves(info);
+  return result;
+}
+
+MoveContainer move_gen::generate_pseudo_legal_moves(const Board& board) {
+  MoveContainer moves;
+  MoveAdder adder{board, moves};
   if (board.is_white_to_move()) {
-    return MoveGen<Color::White>{board}.generate_quiescence_moves_and_checks();
+    PseudoLegalMoveGen<Color::White>{board}.generate_moves<false>(adder);
   } else {
-    return MoveGen<Color::Black>{board}.generate_quiescence_moves_and_checks();
+    PseudoLegalMoveGen<Color::Black>{board}.generate_moves<false>(adder);
   }
+  return moves;
 }
 
-bool move_gen::has_moves(const Board& board) {
+MoveContainer move_gen::generate_pseudo_legal_quiescence_moves(const Board& board) {
+  MoveContainer moves;
+  MoveAdder adder{board, moves};
   if (board.is_white_to_move()) {
-    return MoveGen<Color::White>{board}.has_moves();
+    PseudoLegalMoveGen<Color::White>{board}.generate_moves<true>(adder);
   } else {
-    return MoveGen<Color::Black>{board}.has_moves();
+    PseudoLegalMoveGen<Color::Black>{board}.generate_moves<true>(adder);
   }
+  return moves;
 }
 
-bool move_gen::is_under_attack(const Board& board, Bitboard square) {
+bool move_gen::is_pseudo_legal_move_legal(const Board& board, const Move& move) {
   if (board.is_white_to_move()) {
-    return MoveGen<Color::White>{board}.is_under_attack(square);
+    return PseudoLegalMoveGen<Color::White>{board}.is_legal(move);
+  } else {
+    return PseudoLegalMoveGen<Color::Black>{board}.is_legal(move);
+  }
+}
+
+bool move_gen::is_under_attack(const Board& board, Bitboard square) {
+  const Bitboard occupied{board.cur_player().occupied() | board.opp_player().occupied()};
+  return static_cast<bool>(board.attackers_to(square, occupied) & board.opp_player().occupied());
+}
+
+bool move_gen::is_legal(const Board& board, const Move& move) { return is_legal(BoardInfo{board}, move); }
+
+bool move_gen::is_legal(const BoardInfo& info, const Move& move) {
+  if (info.get_board().is_white_to_move()) {
+    return MoveGen<Color::White>{info}.is_legal(move);
   } else {
-    return MoveGen<Color::Black>{board}.is_under_attack(square);
+    return MoveGen<Color::Black>{info}.is_legal(move);
+  }
+}
+
+StagedMoveGen::StagedMoveGen(const BoardInfo& info, Move hash_move, std::span<const Move> killer_moves)
+    : info{info}, hash_move{hash_move}, killer_moves_count{0}, has_deferred_moves{false}, stage{Stage::None} {
+  for (const Move& killer_move : killer_moves) {
+    if (killer_moves_count == max_killer_moves) break;
+    this->killer_moves[killer_moves_count++] = killer_move;
+  }
+}
+
+bool StagedMoveGen::next_stage(MoveContainer& moves) {
+  moves.clear();
+  while (moves.empty() && stage != Stage::Done) {
+    stage = static_cast<Stage>(static_cast<uint8_t>(stage) + 1);
+    const bool is_in_check{info.is_in_check()};
+    if (is_in_check && (stage == Stage::GoodCapturesAndPromotions || stage == Stage::KillerMoves ||
+                        stage == Stage::QuietMovesAndBadCaptures)) {
+      continue;
+    }
+    if (!is_in_check && stage == Stage::Evasions) continue;
+
+    if (info.get_board().is_white_to_move()) generate_stage<Color::White>(moves);
+    else generate_stage<Color::Black>(moves);
+  }
+  return !moves.empty();
+}
+
+StagedMoveGen::Stage StagedMoveGen::get_stage() const { return stage; }
+
+template <Color PlayerColor>
+void StagedMoveGen::generate_stage(MoveContainer& moves) {
+  const Board& board{info.get_board()};
+  const MoveGen<PlayerColor> move_gen{info};
+  MoveAdder deferred_adder{board, deferred_moves};
+
+  // Removes the hash move (if generated again) from the deferred moves while preserving the order of the other moves.
+  const auto remove_hash_move = [this]() {
+    const auto it = std::find(deferred_moves.begin(), deferred_moves.end(), hash_move);
+    if (it == deferred_moves.end()) return;
+    std::move(it + 1, deferred_moves.end(), it);
+    deferred_moves.pop_back();
+  };
+
+  switch (stage) {
+    case Stage::HashMove:
+      if (hash_move.is_null()) break;
+      if (move_gen.is_in_check() || hash_move.is_capture() || hash_move.is_promotion()) {
+        // The next stage would generate the hash move anyway, so it is generated now and the hash move is legal if it
+        // is found among its moves.
+        if (move_gen.is_in_check()) move_gen.generate_moves(deferred_adder);
+        else move_gen.generate_quiescence_moves(deferred_adder);
+        has_deferred_moves = true;
+        const auto hash_moves_count{deferred_moves.size()};
+        remove_hash_move();
+        if (deferred_moves.size() == hash_moves_count) hash_move = Move::null();
+        else moves.push_back(hash_move);
+      } else if (move_gen.is_legal(hash_move)) {
+        moves.push_back(hash_move);
+      } else {
+        hash_move = Move::null();
+      }
+      break;
+    case Stage::Evasions:
+      if (!has_deferred_moves) {
+        move_gen.generate_moves(deferred_adder);
+        remove_hash_move();
+      }
+      for (const Move& move : deferred_moves) moves.push_back(move);
+      deferred_moves.clear();
+      break;
+    case Stage::GoodCapturesAndPromotions: {
+      if (!has_deferred_moves) {
+        move_gen.generate_quiescence_moves(deferred_adder);
+        remove_hash_move();
+      }
+      // Only the captures that lose material are kept for the last stage.
+      size_t bad_captures_count{0};
+      for (const Move& move : deferred_moves) {
+        if (move.is_capture() && !move.is_promotion() && board.see(move) < 0) {
+          deferred_moves[bad_captures_count++] = move;
+        } else {
+          moves.push_back(move);
+        }
+      }
+      while (deferred_moves.size() > bad_captures_count) deferred_moves.pop_back();
+      break;
+    }
+    case Stage::KillerMoves: {
+      // Only keep killer moves that are legal quiet moves which were not already generated.
+      size_t legal_killer_moves_count{0};
+      for (size_t i{0}; i < killer_moves_count; i++) {
+        const Move killer_move{killer_moves[i]};
+        if (killer_move.is_null() || killer_move == hash_move || killer_move.is_capture() ||
+            killer_move.is_promotion() || std::find(moves.begin(), moves.end(), killer_move) != moves.end() ||
+            !move_gen.is_legal(killer_move)) {
+          continue;
+        }
+        moves.push_back(killer_move);
+        killer_moves[legal_killer_moves_count++] = killer_move;
+      }
+      killer_moves_count = legal_killer_moves_count;
+      break;
+    }
+    case Stage::QuietMovesAndBadCaptures: {
+      MoveAdder adder{board, moves};
+      move_gen.generate_quiet_moves(adder);
+      // Remove the hash move and killer moves, which were generated in earlier stages.
+      const auto killer_moves_end = killer_moves.begin() + killer_moves_count;
+      const auto is_generated = [this, killer_moves_end](const Move& move) {
+        return move == hash_move || std::find(killer_moves.begin(), killer_moves_end, move) != killer_moves_end;
+      };
+      const auto new_end = std::remove_if(moves.begin(), moves.end(), is_generated);
+      while (moves.end() != new_end) moves.pop_back();
+      for (const Move& move : deferred_moves) moves.push_back(move);
+      deferred_moves.clear();
+      break;
+    }
+    default:
+      break;
   }
 }
@@ -0,0 +1,149 @@
+#include "opening_book.h"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "book_keys.h"
+#include "move_gen.h"
+#include "piece.h"
+
+using namespace chess;
+
+namespace {
+// Returns the big-endian number of `N` bytes at the given address.
+template <size_t N>
+uint64_t read_big_endian(const char* data) {
+  uint64_t value{0};
+  for (size_t i{0}; i < N; i++) value = value << 8 | static_cast<uint8_t>(data[i]);
+  return value;
+}
+
+// Writes the `N` byte big-endian representation of the value to the given address.
+template <size_t N>
+void write_big_endian(char* data, uint64_t value) {
+  for (size_t i{0}; i < N; i++) data[i] = static_cast<char>(value >> (8 * (N - 1 - i)));
+}
+}  // namespace
+
+OpeningBook::OpeningBook(const std::filesystem::path& path)
+    : file{path, MappedFile::Access::Random}, entry_count{0} {
+  const size_t size{file.contents().size()};
+  if (size % entry_size != 0) throw std::runtime_error{path.string() + " is not an opening book"};
+  entry_count = size / entry_size;
+}
+
+std::vector<OpeningBook::Entry> OpeningBook::get_entries(const Board& board) const {
+  const uint64_t key{get_key(board)};
+  // Binary search for the first entry with the key.
+  size_t low{0};
+  size_t high{entry_count};
+  while (low < high) {
+    const size_t middle{low + (high - low) / 2};
+    if (get_entry_key(middle) < key) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  std::vector<Entry> entries;
+  if (low == entry_count || get_entry_key(low) != key) return entries;
+  MoveContainer moves{move_gen::generate_moves(board)};
+  for (size_t i{low}; i < entry_count && get_entry_key(i) == key; i++) {
+    const char* const data{file.contents().data() + i * entry_size};
+    const auto encoded_move{static_cast<uint16_t>(read_big_endian<2>(data + 8))};
+    const auto weight{static_cast<uint16_t>(read_big_endian<2>(data + 10))};
+    const auto move{std::find_if(moves.begin(), moves.end(),
+                                 [encoded_move](const Move& move) { return encode_move(move) == encoded_move; })};
+    if (move != moves.end()) entries.push_back(Entry{*move, weight});
+  }
+  return entries;
+}
+
+uint64_t OpeningBook::get_key(const Board& board) {
+  namespace book_keys = detail::book_keys;
+  uint64_t key{0};
+  for (const Color color : {Color::White, Color::Black}) {
+    const Player& player{color == Color::White ? board.get_player<Color::White>() : board.get_player<Color::Black>()};
+    for (int piece{0}; piece < 6; piece++) {
+      for (const Bitboard bit : player[static_cast<PieceType>(piece)].iterate()) {
+        key ^= book_keys::keys[book_keys::piece(color, static_cast<PieceType>(piece), bit.to_index())];
+      }
+    }
+  }
+
+  const Player& white{board.get_player<Color::White>()};
+  const Player& black{board.get_player<Color::Black>()};
+  const std::array<bool, 4> castling_rights{white.can_castle_kingside(), white.can_castle_queenside(),
+                                            black.can_castle_kingside(), black.can_castle_queenside()};
+  for (size_t i{0}; i < castling_rights.size(); i++) {
+    if (castling_rights[i]) key ^= book_keys::keys[book_keys::castling_offset + i];
+  }
+
+  // Unlike `Board::get_hash`, the en passant square only counts if a pawn of the current player is next to the pawn
+  // that moved two squares (even if capturing it is illegal), so that the position after a double push has the same
+  // key as when it is reached by other moves.
+  const Bitboard en_passant{board.get_en_passant()};
+  if (en_passant) {
+    // The pawns that can capture en passant are on the squares attacked by an opponent's pawn on the en passant square.
+    const Bitboard capturers{board.is_white_to_move() ? Pawn::attacks<Color::Black>(en_passant)
+                                                      : Pawn::attacks<Color::White>(en_passant)};
+    if (capturers & board.cur_player()[PieceType::Pawn]) {
+      key ^= book_keys::keys[book_keys::en_passant_offset + en_passant.to_index() % 8];
+    }
+  }
+
+  if (board.is_white_to_move()) key ^= book_keys::keys[book_keys::turn_offset];
+  return key;
+}
+
+uint16_t OpeningBook::encode_move(const Move& move) {
+  const int from{move.get_from().to_index()};
+  int to{move.get_to().to_index()};
+  // The king moves onto its rook's square (on the H file when castling kingside, or the A file when queenside).
+  if (move.is_castle()) to = to > from ? from + 3 : from - 4;
+
+  // Promotion pieces are numbered from 1 (knight) to 4 (queen), or 0 if the move is not a promotion.
+  int promotion{0};
+  switch (move.is_promotion() ? move.get_promotion_piece() : PieceType::None) {
+    case PieceType::Knight:
+      promotion = 1;
+      break;
+    case PieceType::Bishop:
+      promotion = 2;
+      break;
+    case PieceType::Rook:
+      promotion = 3;
+      break;
+    case PieceType::Queen:
+      promotion = 4;
+      break;
+    default:
+      break;
+  }
+  return static_cast<uint16_t>(to | from << 6 | promotion << 12);
+}
+
+void OpeningBook::write(const std::filesystem::path& path, std::vector<RawEntry> entries) {
+  // Entries of the same position are stored from the highest weight.
+  std::sort(entries.begin(), entries.end(), [](const RawEntry& a, const RawEntry& b) {
+    return a.key != b.key ? a.key < b.key : a.weight > b.weight;
+  });
+  std::ofstream file{path, std::ios::binary};
+  for (const RawEntry& entry : entries) {
+    // The last 4 bytes (Polyglot's learning data) are unused.
+    std::array<char, entry_size> data{};
+    write_big_endian<8>(data.data(), entry.key);
+    write_big_endian<2>(data.data() + 8, entry.move);
+    write_big_endian<2>(data.data() + 10, entry.weight);
+    file.write(data.data(), data.size());
+  }
+  if (!file) throw std::runtime_error{"Could not write " + path.string()};
+}
+
+uint64_t OpeningBook::get_entry_key(size_t index) const {
+  return read_big_endian<8>(file.contents().data() + index * entry_size);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "bitboard.h"
+#include "magic_bitboard.h"
+
+// The PEXT backend is only available when compiling for x86-64 with GCC or Clang, as it relies on their target
+// attribute to use BMI2 instructions without requiring them for the rest of the library.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define CHESS_PEXT_BITBOARD
+#include <immintrin.h>
+#endif
+
+using namespace chess;
+
+// Returns the number of entries needed by a PEXT bitboard with the given masks.
+constexpr size_t pext_bitboard_size(const std::array<uint64_t, 64>& masks);
+
+// Lookup of sliding piece attacks indexed by PEXT (parallel bits extract) of the occupancy under the mask, which
+// gives a collision-free index without a magic multiply.
+// Details here: https://www.chessprogramming.org/BMI2#PEXTBitboards
+// Like `MagicBitboard`, the attacks are stored in one flat array that is computed at compile time.
+// `Size` must be `pext_bitboard_size(masks)`.
+template <size_t Size>
+class PextBitboard {
+public:
+  // `directions` and `masks_` are the same as those of the piece's `MagicBitboard`.
+  constexpr PextBitboard(std::array<std::pair<int, int>, 4> directions, std::array<uint64_t, 64> masks_);
+
+#ifdef CHESS_PEXT_BITBOARD
+  // Returns a bitboard of squares attacked by the given bit.
+  // This must only be called if the CPU supports BMI2.
+  __attribute__((target("bmi2"))) Bitboard attacks(Bitboard bit, Bitboard occupancy) const;
+#endif
+
+private:
+  std::array<Bitboard, 64> masks;
+  std::array<uint32_t, 64> offsets;  // Offset of each square's attacks in `moves`.
+  alignas(64) std::array<Bitboard, Size> moves;
+};
+
+// ========== IMPLEMENTATIONS ==========
+
+constexpr size_t pext_bitboard_size(const std::array<uint64_t, 64>& masks) {
+  size_t size{0};
+  for (const uint64_t mask : masks) size += size_t{1} << Bitboard{mask}.count();
+  return size;
+}
+
+template <size_t Size>
+constexpr PextBitboard<Size>::PextBitboard(std::array<std::pair<int, int>, 4> directions,
+                                           std::array<uint64_t, 64> masks_)
+    : masks{}, offsets{}, moves{} {
+  std::transform(masks_.begin(), masks_.end(), masks.begin(), [](uint64_t mask) { return Bitboard{mask}; });
+  uint32_t offset{0};
+  for (int index = 0; index < 64; index++) {
+    offsets[index] = offset;
+    offset += uint32_t{1} << masks[index].count();
+  }
+
+  // Subsets of a mask are traversed in increasing order, which is also the order of their PEXT indices.
+  Bitboard* const moves_data{moves.data()};
+  uint32_t square_offset{0};
+  for_each_slider_attack(directions, masks, [&](int index, uint64_t occupancy, uint64_t attacks) {
+    if (!occupancy) square_offset = offsets[index];
+    moves_data[square_offset++] = Bitboard{attacks};
+  });
+}
+
+#ifdef CHESS_PEXT_BITBOARD
+template <size_t Size>
+__attribute__((target("bmi2"))) inline Bitboard PextBitboard<Size>::attacks(Bitboard bit, Bitboard occupancy) const {
+  int index{bit.to_index()};
+  return moves[offsets[index] + _pext_u64(static_cast<uint64_t>(occupancy), static_cast<uint64_t>(masks[index]))];
+}
+#endif
@@ -0,0 +1,221 @@
+#include "pgn_reader.h"
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+#include <string>
+
+#include "move_gen.h"
+#include "piece.h"
+
+using namespace chess;
+
+namespace {
+// Returns the offset of the start of the line containing the given offset.
+size_t get_line_start(std::string_view contents, size_t offset) {
+  const size_t newline{offset == 0 ? std::string_view::npos : contents.rfind('\n', offset - 1)};
+  return newline == std::string_view::npos ? 0 : newline + 1;
+}
+
+// Returns the offset of the start of the line after the one containing the given offset.
+size_t get_next_line_start(std::string_view contents, size_t offset) {
+  const size_t newline{contents.find('\n', offset)};
+  return newline == std::string_view::npos ? contents.size() : newline + 1;
+}
+
+bool is_result(std::string_view token) {
+  return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*";
+}
+}  // namespace
+
+std::optional<Move> san::move(std::string_view san_move, const Board& board) {
+  // Check, checkmate and annotation suffixes (e.g. `Qh5+!?`) do not change the move.
+  while (!san_move.empty() && std::string_view{"+#!?"}.find(san_move.back()) != std::string_view::npos) {
+    san_move.remove_suffix(1);
+  }
+
+  MoveContainer moves{move_gen::generate_moves(board)};
+  if (san_move == "O-O" || san_move == "O-O-O" || san_move == "0-0" || san_move == "0-0-0") {
+    const bool is_kingside{san_move.size() == 3};
+    for (const Move& move : moves) {
+      if (move.is_castle() && (move.get_to().to_index() > move.get_from().to_index()) == is_kingside) return move;
+    }
+    return std::nullopt;
+  }
+
+  // Pieces other than pawns are written in uppercase, so that `b` is always a file and `B` is always a bishop.
+  PieceType piece{PieceType::Pawn};
+  if (!san_move.empty() && std::string_view{"KQRBN"}.find(san_move.front()) != std::string_view::npos) {
+    piece = piece::from_char(san_move.front());
+    san_move.remove_prefix(1);
+  }
+  PieceType promotion_piece{PieceType::None};
+  if (piece == PieceType::Pawn && !san_move.empty() &&
+      std::string_view{"QRBN"}.find(san_move.back()) != std::string_view::npos) {
+    promotion_piece = piece::from_char(san_move.back());
+    san_move.remove_suffix(1);
+    if (san_move.ends_with('=')) san_move.remove_suffix(1);
+  }
+
+  if (san_move.size() < 2) return std::nullopt;
+  const char to_file{san_move[san_move.size() - 2]};
+  const char to_rank{san_move.back()};
+  if (to_file < 'a' || to_file > 'h' || to_rank < '1' || to_rank > '8') return std::nullopt;
+  const int to_index{(to_rank - '1') * 8 + (to_file - 'a')};
+  san_move.remove_suffix(2);
+
+  // What remains is the file and/or rank that the piece moves from (when it would otherwise be ambiguous), and the
+  // capture sign.
+  int from_file{-1};
+  int from_rank{-1};
+  for (const char c : san_move) {
+    if (c >= 'a' && c <= 'h') {
+      from_file = c - 'a';
+    } else if (c >= '1' && c <= '8') {
+      from_rank = c - '1';
+    } else if (c != 'x' && c != ':' && c != '-') {
+      return std::nullopt;
+    }
+  }
+
+  std::optional<Move> found_move;
+  for (const Move& move : moves) {
+    if (move.get_piece() != piece || move.get_to().to_index() != to_index || move.is_castle()) continue;
+    if ((move.is_promotion() ? move.get_promotion_piece() : PieceType::None) != promotion_piece) continue;
+    const int from_index{move.get_from().to_index()};
+    if ((from_file != -1 && from_index % 8 != from_file) || (from_rank != -1 && from_index / 8 != from_rank)) continue;
+    if (found_move) return std::nullopt;
+    found_move = move;
+  }
+  return found_move;
+}
+
+std::optional<std::string_view> PgnGame::get_tag(std::string_view name) const {
+  for (size_t line_start{0}; line_start < tags.size(); line_start = get_next_line_start(tags, line_start)) {
+    if (tags[line_start] != '[') continue;
+    const size_t name_end{std::min(tags.find_first_of(" \t", line_start), tags.size())};
+    if (tags.substr(line_start + 1, name_end - line_start - 1) != name) continue;
+
+    const size_t value_start{tags.find('"', name_end)};
+    if (value_start == std::string_view::npos) return std::nullopt;
+    // Quotes inside the value are escaped with a backslash.
+    size_t value_end{value_start + 1};
+    while (value_end < tags.size() && tags[value_end] != '"') value_end += tags[value_end] == '\\' ? 2 : 1;
+    value_end = std::min(value_end, tags.size());
+    return tags.substr(value_start + 1, value_end - value_start - 1);
+  }
+  return std::nullopt;
+}
+
+PgnReader::PgnReader(const std::filesystem::path& path, size_t max_plies)
+    : PgnReader{path, 0, all_plies, max_plies} {}
+
+PgnReader::PgnReader(const std::filesystem::path& path, size_t begin, size_t end, size_t max_plies)
+    : file{path}, path{path}, offset{0}, end{end}, max_plies{max_plies} {
+  // Start from the first whole line in the range, so that a game starting before the range is never read.
+  const std::string_view contents{file.contents()};
+  offset = std::min(begin, contents.size());
+  if (offset > 0 && contents[offset - 1] != '\n') offset = get_next_line_start(contents, offset);
+}
+
+std::optional<PgnGame> PgnReader::next() {
+  const std::string_view contents{file.contents()};
+  skip_to_game();
+  if (offset >= std::min(end, contents.size())) return std::nullopt;
+
+  const size_t tags_start{offset};
+  while (offset < contents.size() && contents[offset] == '[') offset = get_next_line_start(contents, offset);
+  std::string_view tags{contents.substr(tags_start, offset - tags_start)};
+  while (!tags.empty() && std::isspace(static_cast<unsigned char>(tags.back()))) tags.remove_suffix(1);
+  PgnGame game{tags, Board::initial(), {}, {}};
+
+  if (const std::optional<std::string_view> fen{game.get_tag("FEN")}) {
+    std::string_view error;
+    const std::optional<Board> board{Board::try_from_fen(*fen, &error)};
+    if (!board) fail(static_cast<size_t>(fen->data() - contents.data()), error);
+    game.board = *board;
+  }
+
+  Board board{game.board};
+  while (true) {
+    offset = std::min(contents.find_first_not_of(" \t\r\n", offset), contents.size());
+    // A game without a termination marker ends at the end of the file or at the tags of the next game.
+    if (offset == contents.size() || contents[offset] == '[') break;
+
+    const char c{contents[offset]};
+    if (c == '{') {
+      const size_t comment_end{contents.find('}', offset)};
+      if (comment_end == std::string_view::npos) fail(offset, "unterminated comment");
+      offset = comment_end + 1;
+      continue;
+    }
+    if (c == ';' || (c == '%' && get_line_start(contents, offset) == offset)) {
+      offset = get_next_line_start(contents, offset);
+      continue;
+    }
+    if (c == '(') {
+      // Variations may be nested, and may contain comments with parentheses.
+      size_t variation_end{offset};
+      int depth{0};
+      do {
+        variation_end = contents.find_first_of("(){", variation_end);
+        if (variation_end == std::string_view::npos) fail(offset, "unterminated variation");
+        if (contents[variation_end] == '{') {
+          variation_end = contents.find('}', variation_end);
+          if (variation_end == std::string_view::npos) fail(offset, "unterminated comment");
+        } else {
+          depth += contents[variation_end] == '(' ? 1 : -1;
+        }
+        variation_end++;
+      } while (depth > 0);
+      offset = variation_end;
+      continue;
+    }
+
+    const size_t token_start{offset};
+    offset = std::min(contents.find_first_of(" \t\r\n{}();[", offset), contents.size());
+    std::string_view token{contents.substr(token_start, offset - token_start)};
+    if (token.empty()) fail(token_start, std::string{"unexpected "} + c);
+    if (is_result(token)) {
+      game.result = token;
+      return game;
+    }
+    // Skip numeric annotation glyphs (e.g. `$1`), and move numbers (e.g. `12.` or `12...`) which may be written
+    // right before the move.
+    if (token.front() == '$') continue;
+    const size_t number_end{token.find_first_not_of("0123456789")};
+    if (number_end == std::string_view::npos) continue;
+    if (token[number_end] == '.') token.remove_prefix(std::min(token.find_first_not_of('.', number_end), token.size()));
+    if (token.empty() || game.moves.size() >= max_plies) continue;
+
+    const std::optional<Move> move{san::move(token, board)};
+    if (!move) fail(token_start, "invalid move " + std::string{token});
+    game.moves.push_back(*move);
+    board.make_move(*move);
+  }
+  game.result = game.get_tag("Result").value_or("*");
+  return game;
+}
+
+void PgnReader::skip_to_game() {
+  // A game starts at a line starting with a tag, which does not follow another line of tags.
+  const std::string_view contents{file.contents()};
+  size_t line_start{get_line_start(contents, offset)};
+  bool follows_tag{line_start > 0 && contents[get_line_start(contents, line_start - 1)] == '['};
+  while (line_start < contents.size()) {
+    const bool is_tag{contents[line_start] == '['};
+    if (is_tag && !follows_tag) break;
+    follows_tag = is_tag;
+    line_start = get_next_line_start(contents, line_start);
+  }
+  offset = line_start;
+}
+
+void PgnReader::fail(size_t error_offset, std::string_view message) {
+  const std::string_view contents{file.contents()};
+  // Line numbers are only counted on errors, so that reading a range of the file does not need to scan before it.
+  const auto line_number{std::count(contents.begin(), contents.begin() + error_offset, '\n') + 1};
+  // Continue after the line of the error, so that the next call to `next` skips to the following game.
+  offset = get_next_line_start(contents, error_offset);
+  throw std::runtime_error{path.string() + ":" + std::to_string(line_number) + ": " + std::string{message}};
+}
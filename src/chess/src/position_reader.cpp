@@ -0,0 +1,75 @@
+#include "position_reader.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+using namespace chess;
+using detail::position_reader::LineReader;
+
+LineReader::LineReader(const std::filesystem::path& path) : file{path}, path{path}, offset{0}, line_number{0} {}
+
+std::optional<std::string_view> LineReader::next() {
+  const std::string_view contents{file.contents()};
+  if (offset >= contents.size()) return std::nullopt;
+  const size_t end{std::min(contents.find('\n', offset), contents.size())};
+  std::string_view line{contents.substr(offset, end - offset)};
+  if (line.ends_with('\r')) line.remove_suffix(1);
+  offset = end + 1;
+  line_number++;
+  return line;
+}
+
+void LineReader::fail(std::string_view message) const {
+  throw std::runtime_error{path.string() + ":" + std::to_string(line_number) + ": " + std::string{message}};
+}
+
+EpdReader::EpdReader(const std::filesystem::path& path) : lines{path} {}
+
+std::optional<EpdEntry> EpdReader::next() {
+  while (const std::optional<std::string_view> line{lines.next()}) {
+    if (line->empty() || line->front() == '#') continue;
+
+    // The position is made up of the first 4 fields of FEN, and the operations follow it.
+    size_t position_end{0};
+    for (int field{0}; field < 4 && position_end != std::string_view::npos; field++) {
+      position_end = line->find_first_not_of(' ', position_end);
+      if (position_end != std::string_view::npos) position_end = line->find(' ', position_end);
+    }
+    position_end = std::min(position_end, line->size());
+
+    std::string_view error;
+    const std::optional<Board> board{Board::try_from_fen(line->substr(0, position_end), &error)};
+    if (!board) lines.fail(error);
+    std::string_view operations{line->substr(position_end)};
+    operations.remove_prefix(std::min(operations.find_first_not_of(' '), operations.size()));
+    return EpdEntry{*board, operations};
+  }
+  return std::nullopt;
+}
+
+CsvPositionReader::CsvPositionReader(const std::filesystem::path& path, size_t fen_column, bool has_header)
+    : lines{path}, fen_column{fen_column} {
+  if (has_header) lines.next();
+}
+
+std::optional<CsvEntry> CsvPositionReader::next() {
+  while (const std::optional<std::string_view> line{lines.next()}) {
+    if (line->empty()) continue;
+
+    size_t column_start{0};
+    for (size_t column{0}; column < fen_column; column++) {
+      column_start = line->find(',', column_start);
+      if (column_start == std::string_view::npos) lines.fail("missing FEN column");
+      column_start++;
+    }
+    const size_t column_end{std::min(line->find(',', column_start), line->size())};
+    const std::string_view fen{line->substr(column_start, column_end - column_start)};
+
+    std::string_view error;
+    const std::optional<Board> board{Board::try_from_fen(fen, &error)};
+    if (!board) lines.fail(error);
+    return CsvEntry{*board, *line};
+  }
+  return std::nullopt;
+}
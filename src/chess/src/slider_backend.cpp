@@ -0,0 +1,45 @@
+#include "slider_backend.h"
+
+#include <cassert>
+
+#include "pext_bitboard.h"
+
+using namespace chess;
+
+namespace {
+// The PEXT backend is preferred when supported, except on AMD CPUs before Zen 3, where PEXT is microcoded and much
+// slower than a magic multiply.
+SliderBackend detect_fastest_backend() {
+#ifdef CHESS_PEXT_BITBOARD
+  // This runs in a static initializer, which may run before the CPU model is initialized for __builtin_cpu_supports
+  // and __builtin_cpu_is, so it is initialized here.
+  __builtin_cpu_init();
+#endif
+  if (!slider_backend::is_supported(SliderBackend::Pext)) return SliderBackend::Magic;
+#ifdef CHESS_PEXT_BITBOARD
+  if (__builtin_cpu_is("znver1") || __builtin_cpu_is("znver2")) return SliderBackend::Magic;
+#endif
+  return SliderBackend::Pext;
+}
+}  // namespace
+
+SliderBackend detail::current_slider_backend{detect_fastest_backend()};
+
+bool slider_backend::is_supported(SliderBackend backend) {
+  switch (backend) {
+    case SliderBackend::Magic:
+      return true;
+    case SliderBackend::Pext:
+#ifdef CHESS_PEXT_BITBOARD
+      return __builtin_cpu_supports("bmi2");
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
+void slider_backend::set(SliderBackend backend) {
+  assert(is_supported(backend));
+  detail::current_slider_backend = backend;
+}
@@ -0,0 +1,324 @@
+#include "tablebase.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "piece.h"
+#include "tablebase_index.h"
+
+using namespace chess;
+using namespace chess::detail::tablebase;
+
+namespace {
+// Pieces in the order that they are written in a material.
+constexpr std::array<PieceType, 6> material_order{PieceType::King,   PieceType::Queen,  PieceType::Rook,
+                                                  PieceType::Bishop, PieceType::Knight, PieceType::Pawn};
+
+// Returns the given square index under the given symmetry. Bit 0 flips the board vertically, bit 1 mirrors it
+// horizontally, and bit 2 reflects it along the A1-H8 diagonal (which is applied first).
+constexpr int transform(int square, int symmetry) {
+  if (symmetry & 4) square = (square >> 3) | ((square & 7) << 3);
+  if (symmetry & 1) square ^= 56;
+  if (symmetry & 2) square ^= 7;
+  return square;
+}
+
+// Squares that white's king is normalized to, and the index of each of those squares (or -1 for other squares).
+struct KingRegion {
+  std::array<int, 32> squares;
+  size_t size;
+  std::array<int, 64> indices;
+};
+
+constexpr KingRegion make_king_region(bool has_pawns) {
+  KingRegion region{};
+  region.indices.fill(-1);
+  for (int square{0}; square < 64; square++) {
+    const int x{square % 8};
+    const int y{square / 8};
+    if (x >= 4 || (!has_pawns && y > x)) continue;
+    region.indices[square] = static_cast<int>(region.size);
+    region.squares[region.size++] = square;
+  }
+  return region;
+}
+
+constexpr std::array<KingRegion, 2> king_regions{make_king_region(false), make_king_region(true)};
+
+// Returns the given board with the colors of the players swapped (and the board flipped vertically), so that it has
+// the flipped material and the same result.
+Board flip_colors(const Board& board) {
+  const auto flip_player{[](const Player& player) {
+    Player flipped{Player::empty()};
+    for (const PieceType piece : material_order) {
+      flipped[piece] = Bitboard{__builtin_bswap64(static_cast<uint64_t>(player[piece]))};
+    }
+    return flipped;
+  }};
+  return Board{flip_player(board.get_player<Color::Black>()), flip_player(board.get_player<Color::White>()),
+               Bitboard::empty, !board.is_white_to_move()};
+}
+
+// Returns whether a pawn of the current player attacks the en passant square (ignoring pins). Every double push sets an
+// en passant square, even when no pawn can capture on it.
+bool can_capture_en_passant(const Board& board) {
+  const Bitboard en_passant{board.get_en_passant()};
+  if (!en_passant) return false;
+  // A pawn attacks the en passant square from the squares that an opponent pawn on it would attack.
+  const Bitboard capturers{board.is_white_to_move() ? Pawn::attacks<Color::Black>(en_passant)
+                                                    : Pawn::attacks<Color::White>(en_passant)};
+  return static_cast<bool>(capturers & board.cur_player()[PieceType::Pawn]);
+}
+
+// Returns the pieces of the given material in the order of `TablebaseIndex::get_pieces` (with unused pieces being white
+// kings).
+std::array<std::pair<Color, PieceType>, max_piece_count> get_material_pieces(const Material& material) {
+  const std::pair<Color, PieceType> white_king{Color::White, PieceType::King};
+  std::array<std::pair<Color, PieceType>, max_piece_count> pieces{white_king, white_king, white_king, white_king,
+                                                                  white_king};
+  pieces[1] = {Color::Black, PieceType::King};
+  size_t i{2};
+  for (const Color color : {Color::White, Color::Black}) {
+    for (const PieceType piece : {PieceType::Queen, PieceType::Rook, PieceType::Bishop, PieceType::Knight,
+                                  PieceType::Pawn}) {
+      for (int j{0}; j < material.count(color, piece) && i < max_piece_count; j++) pieces[i++] = {color, piece};
+    }
+  }
+  return pieces;
+}
+}  // namespace
+
+std::optional<Material> Material::from_string(std::string_view string) {
+  Material material;
+  const size_t separator{string.find('v')};
+  if (separator == std::string_view::npos) return std::nullopt;
+  for (const Color color : {Color::White, Color::Black}) {
+    const std::string_view pieces{color == Color::White ? string.substr(0, separator) : string.substr(separator + 1)};
+    for (const char c : pieces) {
+      const auto piece{std::find_if(material_order.begin(), material_order.end(),
+                                    [c](PieceType piece) { return piece::to_char(piece) + ('A' - 'a') == c; })};
+      if (piece == material_order.end()) return std::nullopt;
+      material.counts[color.to_index()][static_cast<size_t>(*piece)]++;
+    }
+    if (material.count(color, PieceType::King) != 1) return std::nullopt;
+  }
+  return material;
+}
+
+Material Material::of(const Board& board) {
+  Material material;
+  for (const PieceType piece : material_order) {
+    material.counts[Color::White.to_index()][static_cast<size_t>(piece)] =
+        static_cast<uint8_t>(board.get_player<Color::White>()[piece].count());
+    material.counts[Color::Black.to_index()][static_cast<size_t>(piece)] =
+        static_cast<uint8_t>(board.get_player<Color::Black>()[piece].count());
+  }
+  return material;
+}
+
+std::string Material::to_string() const {
+  std::string string;
+  for (const Color color : {Color::White, Color::Black}) {
+    if (color == Color::Black) string += 'v';
+    for (const PieceType piece : material_order) {
+      string.append(count(color, piece), static_cast<char>(piece::to_char(piece) + ('A' - 'a')));
+    }
+  }
+  return string;
+}
+
+int Material::count(Color color, PieceType piece) const { return counts[color.to_index()][static_cast<size_t>(piece)]; }
+
+int Material::count() const {
+  int total{0};
+  for (const auto& color_counts : counts) {
+    for (const uint8_t count : color_counts) total += count;
+  }
+  return total;
+}
+
+Material Material::flip() const {
+  Material flipped{*this};
+  std::swap(flipped.counts[0], flipped.counts[1]);
+  return flipped;
+}
+
+Material Material::add(Color color, PieceType piece, int count) const {
+  Material material{*this};
+  uint8_t& piece_count{material.counts[color.to_index()][static_cast<size_t>(piece)]};
+  piece_count = static_cast<uint8_t>(piece_count + count);
+  return material;
+}
+
+TablebaseIndex::TablebaseIndex(const Material& material)
+    : has_pawns{material.count(Color::White, PieceType::Pawn) + material.count(Color::Black, PieceType::Pawn) > 0},
+      piece_count{static_cast<size_t>(material.count())},
+      pieces{get_material_pieces(material)} {
+  if (piece_count > max_piece_count) {
+    throw std::invalid_argument{"Tablebases of more than " + std::to_string(max_piece_count) +
+                                " pieces are not supported"};
+  }
+}
+
+size_t TablebaseIndex::size() const {
+  size_t size{2 * king_regions[has_pawns].size};
+  for (size_t i{1}; i < piece_count; i++) size *= 64;
+  return size;
+}
+
+size_t TablebaseIndex::get_piece_count() const { return piece_count; }
+
+const std::array<std::pair<Color, PieceType>, max_piece_count>& TablebaseIndex::get_pieces() const { return pieces; }
+
+size_t TablebaseIndex::to_index(const Position& position) const {
+  const KingRegion& region{king_regions[has_pawns]};
+  // When white's king is on a symmetry axis of the region (e.g. the A1-H8 diagonal), more than one symmetry maps it
+  // into the region, and the smallest index of them is used so that every position has a single index.
+  size_t min_index{std::numeric_limits<size_t>::max()};
+  for (int symmetry{0}; symmetry < 8; symmetry++) {
+    // Pawns only move forwards, so boards with pawns can only be mirrored horizontally.
+    if (has_pawns && symmetry != 0 && symmetry != 2) continue;
+    const int king_index{region.indices[transform(position.squares[0], symmetry)]};
+    if (king_index < 0) continue;
+
+    std::array<int, max_piece_count> squares{};
+    for (size_t i{1}; i < piece_count; i++) squares[i] = transform(position.squares[i], symmetry);
+    // Pieces of the same type are interchangeable, so they are sorted by square.
+    for (size_t i{2}; i < piece_count; i++) {
+      for (size_t j{i}; j > 1 && pieces[j - 1] == pieces[j] && squares[j - 1] > squares[j]; j--) {
+        std::swap(squares[j - 1], squares[j]);
+      }
+    }
+
+    size_t index{0};
+    for (size_t i{piece_count - 1}; i > 0; i--) index = index * 64 + static_cast<size_t>(squares[i]);
+    index = index * region.size + static_cast<size_t>(king_index);
+    min_index = std::min(min_index, index);
+  }
+  return min_index * 2 + (position.is_white_turn ? 0 : 1);
+}
+
+Position TablebaseIndex::to_position(size_t index) const {
+  const KingRegion& region{king_regions[has_pawns]};
+  Position position{};
+  position.is_white_turn = index % 2 == 0;
+  index /= 2;
+  position.squares[0] = region.squares[index % region.size];
+  index /= region.size;
+  for (size_t i{1}; i < piece_count; i++) {
+    position.squares[i] = static_cast<int>(index % 64);
+    index /= 64;
+  }
+  return position;
+}
+
+Position TablebaseIndex::from_board(const Board& board) const {
+  Position position{};
+  position.is_white_turn = board.is_white_to_move();
+  Bitboard remaining{Bitboard::full};
+  for (size_t i{0}; i < piece_count; i++) {
+    const auto [color, piece] = pieces[i];
+    const Player& player{color == Color::White ? board.get_player<Color::White>() : board.get_player<Color::Black>()};
+    // Pieces of the same type are taken in increasing order of square.
+    const Bitboard square{(player[piece] & remaining).lsb()};
+    remaining ^= square;
+    position.squares[i] = square.to_index();
+  }
+  return position;
+}
+
+std::optional<Board> TablebaseIndex::to_board(const Position& position) const {
+  Player white{Player::empty()};
+  Player black{Player::empty()};
+  Bitboard occupied{Bitboard::empty};
+  for (size_t i{0}; i < piece_count; i++) {
+    const auto [color, piece] = pieces[i];
+    const Bitboard square{Bitboard::from_index(position.squares[i])};
+    if (occupied & square) return std::nullopt;
+    if (piece == PieceType::Pawn && (square & (Bitboard::rank_1 | Bitboard::rank_8))) return std::nullopt;
+    occupied |= square;
+    (color == Color::White ? white : black)[piece] |= square;
+  }
+
+  const Board board{white, black, Bitboard::empty, position.is_white_turn};
+  const Bitboard opp_king{board.opp_player()[PieceType::King]};
+  if (board.attackers_to(opp_king, occupied) & board.cur_player().occupied()) return std::nullopt;
+  return board;
+}
+
+Tablebase::Tablebase(const std::filesystem::path& path)
+    : file{path, MappedFile::Access::Random}, material{}, entries{nullptr} {
+  const std::string_view contents{file.contents()};
+  Header header;
+  if (contents.size() < sizeof(Header)) throw std::runtime_error{path.string() + " is not a tablebase"};
+  std::memcpy(&header, contents.data(), sizeof(Header));
+  if (std::string_view{header.magic.data(), header.magic.size()} != magic) {
+    throw std::runtime_error{path.string() + " is not a tablebase"};
+  }
+
+  const std::string_view material_string{header.material.data(),
+                                         strnlen(header.material.data(), header.material.size())};
+  const std::optional<Material> parsed_material{Material::from_string(material_string)};
+  if (!parsed_material || parsed_material->count() > static_cast<int>(max_piece_count)) {
+    throw std::runtime_error{path.string() + " has an invalid material"};
+  }
+  material = *parsed_material;
+  if (header.entry_count != TablebaseIndex{material}.size() ||
+      contents.size() != sizeof(Header) + header.entry_count) {
+    throw std::runtime_error{path.string() + " has the wrong size"};
+  }
+  entries = reinterpret_cast<const uint8_t*>(contents.data() + sizeof(Header));
+}
+
+const Material& Tablebase::get_material() const { return material; }
+
+TablebaseResult Tablebase::probe(const Board& board) const {
+  const TablebaseIndex index{material};
+  const uint8_t entry{entries[index.to_index(index.from_board(board))]};
+  if (entry < mate_entry_offset) return TablebaseResult{Wdl::Draw, 0};
+  const int plies_to_mate{entry - mate_entry_offset};
+  return TablebaseResult{plies_to_mate % 2 == 1 ? Wdl::Win : Wdl::Loss, plies_to_mate};
+}
+
+Tablebases Tablebases::load_directory(const std::filesystem::path& directory) {
+  Tablebases tablebases;
+  for (const auto& entry : std::filesystem::directory_iterator{directory}) {
+    if (entry.is_regular_file() && entry.path().extension() == extension) tablebases.add(Tablebase{entry.path()});
+  }
+  return tablebases;
+}
+
+void Tablebases::add(Tablebase tablebase) {
+  max_piece_count = std::max(max_piece_count, tablebase.get_material().count());
+  tablebases.push_back(std::move(tablebase));
+}
+
+bool Tablebases::contains(const Material& material) const {
+  return std::any_of(tablebases.begin(), tablebases.end(), [&material](const Tablebase& tablebase) {
+    return tablebase.get_material() == material || tablebase.get_material() == material.flip();
+  });
+}
+
+int Tablebases::get_max_piece_count() const { return max_piece_count; }
+
+std::optional<TablebaseResult> Tablebases::probe(const Board& board) const {
+  const Player& white{board.get_player<Color::White>()};
+  const Player& black{board.get_player<Color::Black>()};
+  if (can_capture_en_passant(board) || white.can_castle_kingside() || white.can_castle_queenside() ||
+      black.can_castle_kingside() || black.can_castle_queenside()) {
+    return std::nullopt;
+  }
+
+  const Material material{Material::of(board)};
+  if (material.count() == 2) return TablebaseResult{Wdl::Draw, 0};
+
+  for (const Tablebase& tablebase : tablebases) {
+    if (tablebase.get_material() == material) return tablebase.probe(board);
+    if (tablebase.get_material() == material.flip()) return tablebase.probe(flip_colors(board));
+  }
+  return std::nullopt;
+}
@@ -0,0 +1,316 @@
+#include "tablebase_generator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "move_gen.h"
+#include "piece.h"
+#include "tablebase_index.h"
+
+using namespace chess;
+using namespace chess::detail::tablebase;
+
+namespace {
+// Value of a position in `Generator::seeds` that has no seed.
+constexpr uint8_t no_seed{255};
+
+// Calls `function(begin, end, thread)` on `thread_count` threads, which split the range [0, count) between them.
+template <typename Function>
+void parallel_for(size_t count, size_t thread_count, const Function& function) {
+  std::vector<std::thread> threads;
+  for (size_t thread{0}; thread < thread_count; thread++) {
+    threads.emplace_back(function, count * thread / thread_count, count * (thread + 1) / thread_count, thread);
+  }
+  for (std::thread& thread : threads) thread.join();
+}
+
+constexpr bool is_win(uint8_t entry) { return entry >= mate_entry_offset && (entry - mate_entry_offset) % 2 == 1; }
+constexpr bool is_loss(uint8_t entry) { return entry >= mate_entry_offset && (entry - mate_entry_offset) % 2 == 0; }
+
+class Generator {
+public:
+  Generator(const Material& material, const Tablebases& sub_tablebases, size_t thread_count)
+      : material{material},
+        index{material},
+        sub_tablebases{sub_tablebases},
+        thread_count{std::max<size_t>(thread_count, 1)},
+        entries(index.size(), unknown_entry),
+        seeds(index.size(), no_seed) {}
+
+  tablebase_generator::Stats generate() {
+    std::vector<size_t> frontier{initialize()};
+    for (int plies{1}; plies <= max_plies_to_mate; plies++) {
+      if (frontier.empty() && plies > max_seed) break;
+      frontier = resolve(frontier, plies);
+    }
+    if (!frontier.empty()) is_truncated = true;
+    // Storing those positions as draws would give wrong results, so the tablebase cannot be generated.
+    if (is_truncated) {
+      throw std::runtime_error{"Mates of " + material.to_string() + " take longer than " +
+                               std::to_string(max_plies_to_mate) + " plies, which cannot be stored"};
+    }
+
+    tablebase_generator::Stats stats{0, 0, 0, 0};
+    for (uint8_t& entry : entries) {
+      if (entry == unknown_entry) entry = draw_entry;
+      if (entry == draw_entry) stats.draws++;
+      if (is_win(entry)) stats.wins++;
+      if (is_loss(entry)) stats.losses++;
+      if (entry < mate_entry_offset) continue;
+      stats.max_plies_to_mate = std::max(stats.max_plies_to_mate, entry - mate_entry_offset);
+    }
+    return stats;
+  }
+
+  const std::vector<uint8_t>& get_entries() const { return entries; }
+
+private:
+  Material material;
+  TablebaseIndex index;
+  const Tablebases& sub_tablebases;
+  size_t thread_count;
+  std::vector<uint8_t> entries;
+  // The number of plies at which a position is next looked at because of moves that change the material (which are
+  // not found by unmaking moves). For a position with such a move to a lost position, this is the number of plies
+  // that it wins in. Otherwise if all such moves lead to won positions, this is the earliest number of plies that it
+  // may lose in.
+  std::vector<uint8_t> seeds;
+  std::atomic<int> max_seed{0};
+  // Whether some positions take longer to mate than can be stored.
+  std::atomic<bool> is_truncated{false};
+
+  // Marks all indices that are not legal positions as invalid, finds the result of every move that changes the
+  // material, and returns the indices of all checkmates. Stalemates are draws.
+  std::vector<size_t> initialize() {
+    std::vector<std::vector<size_t>> checkmates(thread_count);
+    parallel_for(entries.size(), thread_count, [&](size_t begin, size_t end, size_t thread) {
+      for (size_t i{begin}; i < end; i++) {
+        const Position position{index.to_position(i)};
+        const std::optional<Board> board{index.to_index(position) == i ? index.to_board(position) : std::nullopt};
+        if (!board) {
+          entries[i] = invalid_entry;
+          continue;
+        }
+
+        MoveContainer moves{move_gen::generate_moves(*board)};
+        if (moves.empty()) {
+          entries[i] = board->is_in_check() ? mate_entry_offset : draw_entry;
+          if (entries[i] == mate_entry_offset) checkmates[thread].push_back(i);
+          continue;
+        }
+
+        int min_win{max_plies_to_mate + 1};
+        int max_loss{0};
+        bool has_draw{false};
+        bool has_material_change{false};
+        for (const Move& move : moves) {
+          if (!move.is_capture() && !move.is_promotion()) continue;
+          has_material_change = true;
+          const TablebaseResult result{probe_sub_tablebase(board->apply_move(move))};
+          if (result.wdl == Wdl::Loss) min_win = std::min(min_win, result.plies_to_mate + 1);
+          if (result.wdl == Wdl::Win) max_loss = std::max(max_loss, result.plies_to_mate + 1);
+          if (result.wdl == Wdl::Draw) has_draw = true;
+        }
+        if (min_win <= max_plies_to_mate) {
+          set_seed(i, min_win);
+        } else if (has_material_change && !has_draw) {
+          set_seed(i, max_loss);
+        }
+      }
+    });
+    return merge(checkmates);
+  }
+
+  // Resolves all positions that win or lose in the given number of plies, where `frontier` are the positions that
+  // were resolved in one less ply, and returns their indices. Positions that win are resolved on odd plies, and
+  // positions that lose are resolved on even plies.
+  std::vector<size_t> resolve(const std::vector<size_t>& frontier, int plies) {
+    const bool is_winning{plies % 2 == 1};
+    std::vector<std::vector<size_t>> resolved(thread_count);
+    const auto visit{[&](size_t i, size_t thread) {
+      if (load(i) != unknown_entry) return;
+      if (!is_winning && !loses_in(i, plies)) return;
+      uint8_t expected{unknown_entry};
+      const uint8_t entry{static_cast<uint8_t>(plies + mate_entry_offset)};
+      if (std::atomic_ref{entries[i]}.compare_exchange_strong(expected, entry, std::memory_order_relaxed)) {
+        resolved[thread].push_back(i);
+      }
+    }};
+
+    // A position with a move to a position resolved in one less ply either wins in this many plies (if that position
+    // is lost), or may now lose in this many plies (if that position is won).
+    parallel_for(frontier.size(), thread_count, [&](size_t begin, size_t end, size_t thread) {
+      for (size_t i{begin}; i < end; i++) {
+        for_each_unmove(index.to_position(frontier[i]), [&](size_t previous) { visit(previous, thread); });
+      }
+    });
+    if (plies <= max_seed) {
+      parallel_for(entries.size(), thread_count, [&](size_t begin, size_t end, size_t thread) {
+        for (size_t i{begin}; i < end; i++) {
+          if (seeds[i] == plies) visit(i, thread);
+        }
+      });
+    }
+    return merge(resolved);
+  }
+
+  // Returns whether every move of the given position leads to a won position, and the longest of them wins in one less
+  // than the given number of plies.
+  bool loses_in(size_t i, int plies) {
+    const Board board{*index.to_board(index.to_position(i))};
+    int max_plies{0};
+    for (const Move& move : move_gen::generate_moves(board)) {
+      const Board next_board{board.apply_move(move)};
+      if (move.is_capture() || move.is_promotion()) {
+        const TablebaseResult result{probe_sub_tablebase(next_board)};
+        if (result.wdl != Wdl::Win) return false;
+        max_plies = std::max(max_plies, result.plies_to_mate);
+        continue;
+      }
+      const uint8_t entry{load(index.to_index(index.from_board(next_board)))};
+      if (!is_win(entry)) return false;
+      max_plies = std::max(max_plies, entry - mate_entry_offset);
+    }
+    return max_plies + 1 == plies;
+  }
+
+  // Calls `function` with the index of every position that can reach the given position with a move that does not
+  // change the material (i.e. not a capture or promotion). Castling and en passant are ignored.
+  template <typename Function>
+  void for_each_unmove(Position position, const Function& function) {
+    const Color color{position.is_white_turn ? Color::Black : Color::White};
+    position.is_white_turn = !position.is_white_turn;
+    Bitboard occupied{Bitboard::empty};
+    for (size_t i{0}; i < index.get_piece_count(); i++) occupied |= Bitboard::from_index(position.squares[i]);
+
+    for (size_t i{0}; i < index.get_piece_count(); i++) {
+      const auto [piece_color, piece] = index.get_pieces()[i];
+      if (piece_color != color) continue;
+      const int square{position.squares[i]};
+      for (const Bitboard from : get_unmoves(piece, color, Bitboard::from_index(square), occupied).iterate()) {
+        position.squares[i] = from.to_index();
+        const size_t previous{index.to_index(position)};
+        if (load(previous) != invalid_entry) function(previous);
+      }
+      position.squares[i] = square;
+    }
+  }
+
+  // Returns the squares that a piece of the given type and color could have moved to `square` from without capturing.
+  static Bitboard get_unmoves(PieceType piece, Color color, Bitboard square, Bitboard occupied) {
+    switch (piece) {
+      case PieceType::King:
+        return King::attacks(square) & ~occupied;
+      case PieceType::Queen:
+        return Queen::attacks(square, occupied) & ~occupied;
+      case PieceType::Rook:
+        return Rook::attacks(square, occupied) & ~occupied;
+      case PieceType::Bishop:
+        return Bishop::attacks(square, occupied) & ~occupied;
+      case PieceType::Knight:
+        return Knight::attacks(square) & ~occupied;
+      case PieceType::Pawn: {
+        // Pawns cannot have come from the first rank, nor double pushed to anywhere but the fourth rank.
+        const bool is_white{color == Color::White};
+        const Bitboard single{(is_white ? square >> 8 : square << 8) & ~occupied};
+        if (single & (Bitboard::rank_1 | Bitboard::rank_8)) return Bitboard::empty;
+        const Bitboard fourth_rank{is_white ? Bitboard::rank_4 : Bitboard::rank_5};
+        if (!(square & fourth_rank) || !single) return single;
+        return single | ((is_white ? single >> 8 : single << 8) & ~occupied);
+      }
+      default:
+        return Bitboard::empty;
+    }
+  }
+
+  // Entries are read with atomic loads, as other threads may be resolving them at the same time.
+  uint8_t load(size_t i) { return std::atomic_ref{entries[i]}.load(std::memory_order_relaxed); }
+
+  TablebaseResult probe_sub_tablebase(const Board& board) const {
+    const std::optional<TablebaseResult> result{sub_tablebases.probe(board)};
+    if (!result) throw std::runtime_error{"Missing tablebase " + Material::of(board).to_string()};
+    return *result;
+  }
+
+  void set_seed(size_t i, int plies) {
+    if (plies > max_plies_to_mate) {
+      is_truncated = true;
+      return;
+    }
+    seeds[i] = static_cast<uint8_t>(plies);
+    int current_max{max_seed.load(std::memory_order_relaxed)};
+    while (current_max < plies && !max_seed.compare_exchange_weak(current_max, plies, std::memory_order_relaxed)) {
+    }
+  }
+
+  static std::vector<size_t> merge(const std::vector<std::vector<size_t>>& indices) {
+    std::vector<size_t> merged;
+    for (const std::vector<size_t>& thread_indices : indices) {
+      merged.insert(merged.end(), thread_indices.begin(), thread_indices.end());
+    }
+    return merged;
+  }
+};
+}  // namespace
+
+std::vector<Material> tablebase_generator::get_sub_materials(const Material& material) {
+  constexpr std::array<PieceType, 5> capturable{PieceType::Queen, PieceType::Rook, PieceType::Bishop,
+                                                PieceType::Knight, PieceType::Pawn};
+  constexpr std::array<PieceType, 4> promotions{PieceType::Queen, PieceType::Rook, PieceType::Bishop,
+                                                PieceType::Knight};
+  std::vector<Material> sub_materials;
+  const auto add{[&](const Material& sub_material) {
+    if (sub_material.count() == 2) return;
+    if (std::find(sub_materials.begin(), sub_materials.end(), sub_material) != sub_materials.end()) return;
+    sub_materials.push_back(sub_material);
+  }};
+
+  for (const Color color : {Color::White, Color::Black}) {
+    const Color opponent{color.flip()};
+    // Captures by `color`.
+    for (const PieceType captured : capturable) {
+      if (material.count(opponent, captured) > 0) add(material.add(opponent, captured, -1));
+    }
+    // Promotions by `color`, which may also capture (but not a pawn, which cannot be on the last rank).
+    if (material.count(color, PieceType::Pawn) == 0) continue;
+    for (const PieceType promotion : promotions) {
+      const Material promoted{material.add(color, PieceType::Pawn, -1).add(color, promotion, 1)};
+      add(promoted);
+      for (const PieceType captured : promotions) {
+        if (material.count(opponent, captured) > 0) add(promoted.add(opponent, captured, -1));
+      }
+    }
+  }
+  return sub_materials;
+}
+
+tablebase_generator::Stats tablebase_generator::generate(const Material& material, const Tablebases& sub_tablebases,
+                                                         const std::filesystem::path& path, size_t thread_count) {
+  for (const Material& sub_material : get_sub_materials(material)) {
+    if (!sub_tablebases.contains(sub_material)) {
+      throw std::runtime_error{"Missing tablebase " + sub_material.to_string()};
+    }
+  }
+
+  Generator generator{material, sub_tablebases, thread_count};
+  const Stats stats{generator.generate()};
+
+  Header header{};
+  std::memcpy(header.magic.data(), magic.data(), magic.size());
+  const std::string material_string{material.to_string()};
+  std::memcpy(header.material.data(), material_string.data(), material_string.size());
+  header.entry_count = generator.get_entries().size();
+
+  std::ofstream file{path, std::ios::binary};
+  file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+  file.write(reinterpret_cast<const char*>(generator.get_entries().data()),
+             static_cast<std::streamsize>(generator.get_entries().size()));
+  if (!file) throw std::runtime_error{"Failed to write " + path.string()};
+  return stats;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include "board.h"
+#include "tablebase.h"
+
+namespace chess::detail::tablebase {
+
+// A tablebase file is a header followed by one entry (byte) for each index of its material.
+constexpr std::string_view magic{"chesstb1"};
+struct Header {
+  std::array<char, 8> magic;
+  std::array<char, 24> material;  // Padded with null characters.
+  uint64_t entry_count;
+};
+static_assert(sizeof(Header) == 40);
+
+// Values of the entries.
+constexpr uint8_t draw_entry{0};
+// The index is not a legal position, or is not the index of its position (see `TablebaseIndex::to_index`).
+constexpr uint8_t invalid_entry{1};
+// Otherwise, the entry is the number of plies to mate plus `mate_entry_offset`. The current player wins if the number
+// of plies is odd, and loses if it is even.
+constexpr uint8_t mate_entry_offset{2};
+constexpr int max_plies_to_mate{252};
+// Only used while generating a tablebase, for positions whose result is not known yet.
+constexpr uint8_t unknown_entry{255};
+
+// Largest number of pieces (including kings) that can be indexed.
+constexpr size_t max_piece_count{5};
+
+// The squares (as indices) of all pieces of a material, in the order of `TablebaseIndex::get_pieces`.
+struct Position {
+  std::array<int, max_piece_count> squares;
+  bool is_white_turn;
+};
+
+// Maps the positions of a material to the indices [0, size()) of its tablebase.
+// The board is mirrored so that white's king is on files A to D, and if there are no pawns, also flipped so that it is
+// in the triangle A1-D1-D4. An index is then made of the side to move, white's king square in that region, and the
+// squares of all other pieces.
+class TablebaseIndex {
+public:
+  // The material must have at most `max_piece_count` pieces.
+  explicit TablebaseIndex(const Material& material);
+
+  // Returns the number of indices.
+  size_t size() const;
+
+  // Returns the number of pieces, including kings.
+  size_t get_piece_count() const;
+
+  // Returns the color and type of each piece of a position, which are white's king, black's king, then white's other
+  // pieces and black's other pieces (each in the order of PieceType).
+  const std::array<std::pair<Color, PieceType>, max_piece_count>& get_pieces() const;
+
+  // Returns the index of the given position. Positions that are the same up to symmetry (and the order of pieces of
+  // the same type) have the same index, so some indices are never returned.
+  size_t to_index(const Position& position) const;
+
+  // Returns the position at the given index.
+  Position to_position(size_t index) const;
+
+  // Returns the position of the given board, which must have this material.
+  Position from_board(const Board& board) const;
+
+  // Returns the board of the given position, or std::nullopt if it is not legal (pieces on the same square, pawns on
+  // the first or last rank, or the player who is not to move is in check).
+  std::optional<Board> to_board(const Position& position) const;
+
+private:
+  bool has_pawns;
+  size_t piece_count;
+  std::array<std::pair<Color, PieceType>, max_piece_count> pieces;
+};
+
+}  // namespace chess::detail::tablebase
@@ -0,0 +1,228 @@
+// This program builds an opening book (see chess/opening_book.h) from the games of PGN files. Each book move is
+// weighted by the points that it scored for the player who made it (2 for a win and 1 for a draw).
+// Usage: chess_book_builder [--threads <count>] [--plies <count>] [--min-games <count>] <output> <pgn>...
+// e.g. `chess_book_builder --plies 16 --min-games 5 book.bin lichess_db_standard_rated_2024-01.pgn`.
+//
+// The PGN files are memory mapped and split into chunks that are read by all threads in parallel. The statistics of
+// each (position, move) are counted in hash maps that are sharded by position, each with its own lock.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "chess/board.h"
+#include "chess/opening_book.h"
+#include "chess/pgn_reader.h"
+
+namespace {
+// Bounds of the number of bytes of a PGN file that a thread reads at a time.
+constexpr size_t min_chunk_size{size_t{1} << 20};
+constexpr size_t max_chunk_size{size_t{64} << 20};
+
+// A move made from a position, identified by their encodings in the book.
+struct BookMove {
+  uint64_t key;
+  uint16_t move;
+
+  bool operator==(const BookMove& other) const = default;
+};
+
+struct BookMoveHash {
+  size_t operator()(const BookMove& book_move) const {
+    // Keys are Zobrist hashes, which are already uniformly distributed.
+    return static_cast<size_t>(book_move.key ^ (uint64_t{book_move.move} * 0x9E3779B97F4A7C15));
+  }
+};
+
+struct MoveStats {
+  uint32_t games;
+  uint32_t points;
+};
+
+// A move made in a game, along with the points that it scored.
+struct Sample {
+  BookMove book_move;
+  uint32_t points;
+};
+
+// Statistics of all moves, split into shards by the key of their position.
+class ShardedStats {
+public:
+  static constexpr size_t shard_count{256};
+
+  static size_t get_shard_index(uint64_t key) { return key >> 56; }
+
+  // Adds the given samples of each shard, and clears them.
+  void add(std::array<std::vector<Sample>, shard_count>& samples) {
+    for (size_t i{0}; i < shard_count; i++) {
+      if (samples[i].empty()) continue;
+      const std::lock_guard lock{shards[i].mutex};
+      for (const Sample& sample : samples[i]) {
+        MoveStats& stats{shards[i].stats[sample.book_move]};
+        stats.games++;
+        stats.points += sample.points;
+      }
+      samples[i].clear();
+    }
+  }
+
+  // Returns the book entries of the moves made in at least `min_games` games. The weights of each position are scaled
+  // down if they do not fit in 16 bits. This must not be called concurrently with `add`.
+  std::vector<chess::OpeningBook::RawEntry> get_entries(uint32_t min_games) const {
+    std::vector<chess::OpeningBook::RawEntry> entries;
+    std::unordered_map<uint64_t, uint32_t> max_points;
+    for (const Shard& shard : shards) {
+      max_points.clear();
+      for (const auto& [book_move, stats] : shard.stats) {
+        if (stats.games >= min_games) max_points[book_move.key] = std::max(max_points[book_move.key], stats.points);
+      }
+      for (const auto& [book_move, stats] : shard.stats) {
+        if (stats.games < min_games || stats.points == 0) continue;
+        const uint64_t scale{std::max<uint64_t>(max_points[book_move.key], UINT16_MAX)};
+        const auto weight{static_cast<uint16_t>(std::max<uint64_t>(uint64_t{stats.points} * UINT16_MAX / scale, 1))};
+        entries.push_back({book_move.key, book_move.move, weight});
+      }
+    }
+    return entries;
+  }
+
+private:
+  struct Shard {
+    std::mutex mutex;
+    std::unordered_map<BookMove, MoveStats, BookMoveHash> stats;
+  };
+  std::array<Shard, shard_count> shards;
+};
+
+// A range of bytes of a PGN file.
+struct Chunk {
+  std::filesystem::path path;
+  size_t begin;
+  size_t end;
+};
+
+// Counters of the games read by all threads.
+struct Progress {
+  std::atomic<size_t> games{0};
+  std::atomic<size_t> invalid_games{0};
+  std::mutex output_mutex;
+};
+
+// Reads the games of the chunks (taking the next unread chunk from `next_chunk`) into `stats`.
+void read_chunks(const std::vector<Chunk>& chunks, std::atomic<size_t>& next_chunk, size_t max_plies,
+                 ShardedStats& stats, Progress& progress) {
+  // Samples are added to the shared statistics in batches, so that each lock is taken once per batch.
+  constexpr size_t batch_size{size_t{1} << 16};
+  std::array<std::vector<Sample>, ShardedStats::shard_count> samples;
+  size_t sample_count{0};
+
+  for (size_t chunk_index{next_chunk++}; chunk_index < chunks.size(); chunk_index = next_chunk++) {
+    const Chunk& chunk{chunks[chunk_index]};
+    chess::PgnReader reader{chunk.path, chunk.begin, chunk.end, max_plies};
+    while (true) {
+      std::optional<chess::PgnGame> game;
+      try {
+        game = reader.next();
+      } catch (const std::runtime_error& error) {
+        progress.invalid_games++;
+        const std::lock_guard lock{progress.output_mutex};
+        std::cerr << "Skipping game: " << error.what() << "\n";
+        continue;
+      }
+      if (!game) break;
+      progress.games++;
+
+      const uint32_t white_points{game->result == "1-0" ? 2u : game->result == "0-1" ? 0u : 1u};
+      chess::Board board{game->board};
+      for (const chess::Move& move : game->moves) {
+        const uint64_t key{chess::OpeningBook::get_key(board)};
+        const uint32_t points{board.is_white_to_move() ? white_points : 2 - white_points};
+        samples[ShardedStats::get_shard_index(key)].push_back({{key, chess::OpeningBook::encode_move(move)}, points});
+        board.make_move(move);
+      }
+      sample_count += game->moves.size();
+      if (sample_count >= batch_size) {
+        stats.add(samples);
+        sample_count = 0;
+      }
+    }
+  }
+  stats.add(samples);
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  size_t thread_count{std::max(std::thread::hardware_concurrency(), 1u)};
+  size_t max_plies{20};
+  uint32_t min_games{1};
+  std::vector<std::filesystem::path> paths;
+  for (int i{1}; i < argc; i++) {
+    const std::string_view argument{argv[i]};
+    if (argument == "--threads" && i + 1 < argc) {
+      thread_count = std::max(std::stoul(argv[++i]), 1ul);
+    } else if (argument == "--plies" && i + 1 < argc) {
+      max_plies = std::stoul(argv[++i]);
+    } else if (argument == "--min-games" && i + 1 < argc) {
+      min_games = static_cast<uint32_t>(std::stoul(argv[++i]));
+    } else {
+      paths.push_back(argument);
+    }
+  }
+  if (paths.size() < 2) {
+    std::cerr << "Usage: chess_book_builder [--threads <count>] [--plies <count>] [--min-games <count>] <output> "
+                 "<pgn>...\n";
+    return 1;
+  }
+  const std::filesystem::path output_path{paths.front()};
+  paths.erase(paths.begin());
+
+  try {
+    std::vector<Chunk> chunks;
+    for (const std::filesystem::path& path : paths) {
+      const size_t size{std::filesystem::file_size(path)};
+      // Each thread reads several chunks, so that threads which finish early can take over the work of slower ones.
+      const size_t chunk_size{std::clamp(size / (thread_count * 8), min_chunk_size, max_chunk_size)};
+      for (size_t begin{0}; begin < size; begin += chunk_size) {
+        chunks.push_back({path, begin, std::min(begin + chunk_size, size)});
+      }
+    }
+
+    const auto start_time{std::chrono::steady_clock::now()};
+    ShardedStats stats;
+    Progress progress;
+    std::atomic<size_t> next_chunk{0};
+    std::vector<std::thread> threads;
+    for (size_t i{0}; i < thread_count; i++) {
+      threads.emplace_back(read_chunks, std::cref(chunks), std::ref(next_chunk), max_plies, std::ref(stats),
+                           std::ref(progress));
+    }
+    for (std::thread& thread : threads) thread.join();
+
+    std::vector<chess::OpeningBook::RawEntry> entries{stats.get_entries(min_games)};
+    const size_t entry_count{entries.size()};
+    chess::OpeningBook::write(output_path, std::move(entries));
+    const auto elapsed{std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                             start_time)};
+    std::cout << "Read " << progress.games << " games (skipped " << progress.invalid_games << " invalid games), and "
+              << "wrote " << entry_count << " entries to " << output_path.string() << " (" << elapsed.count()
+              << "ms)\n";
+  } catch (const std::exception& error) {
+    std::cerr << error.what() << "\n";
+    return 1;
+  }
+}
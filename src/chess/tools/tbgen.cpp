@@ -0,0 +1,73 @@
+// This program generates endgame tablebases (see chess/tablebase.h) for the given materials, along with the
+// tablebases of all materials that they can reach by captures and promotions.
+// Usage: chess_tbgen [--threads <count>] [--output <directory>] <material>...
+// e.g. `chess_tbgen --threads 8 --output tablebases KQvK KRPvKR`.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "chess/tablebase.h"
+#include "chess/tablebase_generator.h"
+
+namespace {
+// Generates the tablebase of the given material after those of its sub materials, unless it is already in
+// `tablebases`. Generated tablebases are written to `directory` and added to `tablebases`.
+void generate(const chess::Material& material, chess::Tablebases& tablebases, const std::filesystem::path& directory,
+              size_t thread_count) {
+  if (material.count() == 2 || tablebases.contains(material)) return;
+  for (const chess::Material& sub_material : chess::tablebase_generator::get_sub_materials(material)) {
+    generate(sub_material, tablebases, directory, thread_count);
+  }
+
+  const std::filesystem::path path{directory /
+                                   (material.to_string() + std::string{chess::Tablebases::extension})};
+  std::cout << "Generating " << material.to_string() << "..." << std::flush;
+  const auto start_time{std::chrono::steady_clock::now()};
+  const auto stats{chess::tablebase_generator::generate(material, tablebases, path, thread_count)};
+  const auto elapsed{std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                           start_time)};
+  std::cout << " " << stats.wins << " wins, " << stats.draws << " draws, " << stats.losses << " losses, longest mate "
+            << stats.max_plies_to_mate << " plies (" << elapsed.count() << "ms)\n";
+  tablebases.add(chess::Tablebase{path});
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  size_t thread_count{std::max(std::thread::hardware_concurrency(), 1u)};
+  std::filesystem::path directory{"."};
+  std::vector<chess::Material> materials;
+  for (int i{1}; i < argc; i++) {
+    const std::string_view argument{argv[i]};
+    if (argument == "--threads" && i + 1 < argc) {
+      thread_count = std::stoul(argv[++i]);
+    } else if (argument == "--output" && i + 1 < argc) {
+      directory = argv[++i];
+    } else if (const auto material{chess::Material::from_string(argument)}) {
+      materials.push_back(*material);
+    } else {
+      std::cerr << "Invalid material " << argument << "\n";
+      return 1;
+    }
+  }
+  if (materials.empty()) {
+    std::cerr << "Usage: chess_tbgen [--threads <count>] [--output <directory>] <material>...\n";
+    return 1;
+  }
+
+  try {
+    std::filesystem::create_directories(directory);
+    chess::Tablebases tablebases{chess::Tablebases::load_directory(directory)};
+    for (const chess::Material& material : materials) generate(material, tablebases, directory, thread_count);
+  } catch (const std::exception& error) {
+    std::cerr << error.what() << "\n";
+    return 1;
+  }
+}
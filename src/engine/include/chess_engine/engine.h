@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstddef>
+#include <filesystem>
 #include <memory>
+#include <optional>
 #include <span>
 #include <utility>
 
@@ -22,6 +25,23 @@ public:
   // Apply the given move to the board.
   void apply_move(const chess::Move& move);
 
+  // Resizes the transposition table to the given size in MiB (the UCI Hash option), which clears it along with all
+  // other data cached by previous searches. Throws `std::bad_alloc` if the new table cannot be allocated, in which case
+  // the old table is kept.
+  void set_hash_size(size_t size_mb);
+
+  // Maps the opening book (see chess::OpeningBook) at the given path, which is used by `get_book_move`.
+  // Throws a `std::runtime_error` if it cannot be read.
+  void load_opening_book(const std::filesystem::path& path);
+
+  // Returns a random move (weighted by the book) from the opening book for the current position, or std::nullopt if
+  // there is no book or the position is not in it. This takes microseconds, so it should be tried before searching.
+  [[nodiscard]] std::optional<chess::Move> get_book_move();
+
+  // Loads the endgame tablebases (generated by chess_tbgen) in the given directory, which are probed by all later
+  // searches. Throws a `std::runtime_error` if they cannot be read.
+  void load_tablebases(const std::filesystem::path& directory);
+
   // Performs a search with configurations based on the uci go command.
   // The search can be interacted with through the returned Search object.
   [[nodiscard]] std::shared_ptr<engine::Search> search(engine::uci::SearchConfig config);
@@ -22,6 +22,7 @@ public:
     int64_t q_delta_pruning_success;       // Nodes that were delta pruned.
     int64_t q_delta_pruning_total;         // Nodes that tried to delta prune.
     int32_t search_depth;                  // Maximum depth reached during search.
+    int32_t hashfull;                      // Permille of the transposition table filled by this search (estimated).
     std::chrono::milliseconds time_spent;  // Time in milliseconds spent searching.
     bool timed_out;                        // True if search could have reached a higher depth with more time.
   };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <vector>
@@ -30,6 +31,8 @@ struct SearchConfig {
   std::optional<int64_t> nodes;
   std::optional<std::chrono::milliseconds> movetime;
   bool infinite;
+  // Number of threads to search with (at least 1). This is the UCI `Threads` option rather than a go command option.
+  size_t threads;
 
   SearchConfig& add_search_move(chess::Move move);
   SearchConfig& set_wtime(std::chrono::milliseconds time);
@@ -40,6 +43,7 @@ struct SearchConfig {
   SearchConfig& set_nodes(int64_t nodes);
   SearchConfig& set_movetime(std::chrono::milliseconds time);
   SearchConfig& set_infinite(bool infinite);
+  SearchConfig& set_threads(size_t threads);
 };
 
 }  // namespace engine::uci
\ No newline at end of file
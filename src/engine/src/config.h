@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 #include "evaluation.h"
 
 // Configuration for the engine.
@@ -16,8 +19,12 @@ constexpr int null_move_heuristic_R = 2;
 // Maximum depth the engine searches to.
 constexpr int max_depth = 64;
 
-// Size of transposition table. Roughly 4 million.
-constexpr int transposition_table_size = 1 << 22;
+// How often helper threads of a search check whether they should stop, every time this number of nodes is visited.
+// This must be a power of two.
+constexpr int64_t helper_check_interval = 256;
+
+// Default size of the transposition table in MiB (the UCI Hash option), which holds 4 million entries.
+constexpr size_t default_hash_size_mb = 64;
 
 // If the expected value of a move does not raise evaluation to within this amount of the alpha, then prune it.
 constexpr Evaluation futility_margin{500};
@@ -16,6 +16,14 @@ void Engine::reset() { impl->reset(); }
 
 void Engine::apply_move(const chess::Move& move) { impl->apply_move(move); }
 
+void Engine::set_hash_size(size_t size_mb) { impl->set_hash_size(size_mb); }
+
+void Engine::load_opening_book(const std::filesystem::path& path) { impl->load_opening_book(path); }
+
+std::optional<chess::Move> Engine::get_book_move() { return impl->get_book_move(); }
+
+void Engine::load_tablebases(const std::filesystem::path& directory) { impl->load_tablebases(directory); }
+
 std::shared_ptr<engine::Search> Engine::search(engine::uci::SearchConfig config) {
   return impl->search(std::move(config));
 }
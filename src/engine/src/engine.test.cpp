@@ -3,12 +3,16 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <filesystem>
 #include <iostream>
+#include <string>
 #include <string_view>
 #include <utility>
 
 #include "chess/board.h"
 #include "chess/move.h"
+#include "chess/tablebase.h"
+#include "chess/tablebase_generator.h"
 #include "chess_engine/uci.h"
 
 chess::Move choose_move_for_fen(std::string_view fen, int depth) {
@@ -47,6 +51,32 @@ TEST(CheckMate, MateInSix) {
   EXPECT_EQ(move.to_uci(), "c2f2");
 }
 
+TEST(Endgame, KingAndPawnVsKing) {
+  // Kd3 is the only winning move, as it takes the opposition.
+  chess::Move move = choose_move_for_fen("8/8/8/3k4/8/8/2K1P3/8 w - - 0 0", 4);
+  EXPECT_EQ(move.to_uci(), "c2d3");
+}
+
+TEST(Endgame, RookVsKingWithTablebases) {
+  const std::filesystem::path directory{std::filesystem::temp_directory_path() / "chess_engine_tablebase_test"};
+  std::filesystem::create_directories(directory);
+  const chess::Material material{chess::Material::from_string("KRvK").value()};
+  const std::filesystem::path path{directory / (material.to_string() + std::string{chess::Tablebases::extension})};
+  chess::tablebase_generator::generate(material, chess::Tablebases{}, path, 1);
+  chess::Tablebases tablebases;
+  tablebases.add(chess::Tablebase{path});
+
+  // The mate is too deep to be searched, so the move must be found by probing the tablebase after each move.
+  const chess::Board board{chess::Board::from_fen("8/8/8/4k3/8/8/8/R3K3 w - - 0 0")};
+  Engine engine{board};
+  engine.load_tablebases(directory);
+  const chess::Move move{engine.search_sync(engine::uci::SearchConfig::from_depth(2)).first};
+  const chess::TablebaseResult result{tablebases.probe(board).value()};
+  const chess::TablebaseResult result_after_move{tablebases.probe(board.apply_move(move)).value()};
+  EXPECT_EQ(result_after_move.wdl, chess::Wdl::Loss);
+  EXPECT_EQ(result_after_move.plies_to_mate, result.plies_to_mate - 1);
+}
+
 TEST(HangingPieces, FreePawn) {
   chess::Move move = choose_move_for_fen("rnbqkbnr/pppp1ppp/8/4p3/3P4/8/PPP1PPPP/RNBQKBNR w KQkq - 0 0", 10);
   EXPECT_EQ(move.to_uci(), "d4e5");
@@ -79,6 +109,39 @@ TEST(HangingPieces, FreePawn) {
 //   EXPECT_EQ(move.to_uci(), "e7d8");
 // }
 
+TEST(LazySmp, MateInThreeWithThreads) {
+  Engine engine{chess::Board::from_fen("8/p4pkp/4r3/8/3P2pP/2P1q1P1/4Q3/5K1R b - - 0 0")};
+  const auto [move, debug_info] = engine.search_sync(engine::uci::SearchConfig::from_depth(6).set_threads(4));
+  EXPECT_EQ(move.to_uci(), "e3e2");
+  EXPECT_EQ(debug_info.search_depth, 6);
+}
+
+TEST(LazySmp, StopsWithinMovetime) {
+  Engine engine{chess::Board::initial()};
+  const auto start_time{std::chrono::steady_clock::now()};
+  const auto [move, debug_info] = engine.search_sync(
+      engine::uci::SearchConfig{}.set_movetime(std::chrono::milliseconds{100}).set_threads(4));
+  EXPECT_LE(std::chrono::steady_clock::now() - start_time, std::chrono::milliseconds{99});
+  EXPECT_FALSE(move.is_null());
+}
+
+TEST(TranspositionTable, MateInThreeWithSmallHash) {
+  Engine engine{chess::Board::from_fen("8/p4pkp/4r3/8/3P2pP/2P1q1P1/4Q3/5K1R b - - 0 0")};
+  engine.set_hash_size(1);
+  const auto [move, debug_info] = engine.search_sync(engine::uci::SearchConfig::from_depth(6));
+  EXPECT_EQ(move.to_uci(), "e3e2");
+  EXPECT_GT(debug_info.hashfull, 0);
+  EXPECT_LE(debug_info.hashfull, 1000);
+}
+
+TEST(TranspositionTable, HashfullCountsOnlyCurrentSearch) {
+  Engine engine{chess::Board::initial()};
+  engine.set_hash_size(1);
+  EXPECT_GT(engine.search_sync(engine::uci::SearchConfig::from_depth(6)).second.hashfull, 0);
+  // Entries of the previous search are not counted, and a shallow search stores few entries.
+  EXPECT_LT(engine.search_sync(engine::uci::SearchConfig::from_depth(1)).second.hashfull, 10);
+}
+
 // The TimeManagement test suite tests that the engine finishes at least 1ms before the deadline.
 
 void expect_time_management(chess::Board position, std::chrono::milliseconds movetime) {
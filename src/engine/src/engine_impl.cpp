@@ -1,14 +1,26 @@
 #include "engine_impl.h"
 
+#include <ctime>
+
+#include "chess/kpk.h"
+#include "config.h"
 #include "search_impl.h"
 
 Engine::Impl::Impl(chess::Board position, std::span<chess::Move const> moves)
-    : current_position{chess::Board::initial()}, repetition_tracker{}, heuristics{std::make_shared<Heuristics>()} {
+    : current_position{chess::Board::initial()},
+      repetition_tracker{},
+      hash_size_mb{config::default_hash_size_mb},
+      heuristics{std::make_shared<Heuristics>(hash_size_mb)},
+      tablebases{nullptr},
+      opening_book{},
+      random{static_cast<std::mt19937_64::result_type>(std::time(nullptr))} {
+  // The KPK bitbase is probed by the search, so it is generated now rather than while a search is timed.
+  chess::kpk::init();
   set_position(std::move(position), moves);
 }
 
 void Engine::Impl::set_position(chess::Board position, std::span<chess::Move const> moves) {
-  repetition_tracker = chess::StackRepetitionTracker{};
+  repetition_tracker = chess::FixedRepetitionTracker{};
   current_position = position;
   repetition_tracker.push(current_position);
   for (const auto& move : moves) {
@@ -19,7 +31,7 @@ void Engine::Impl::set_position(chess::Board position, std::span<chess::Move con
 
 void Engine::Impl::reset() {
   // Reset all cached data.
-  heuristics = std::make_shared<Heuristics>();
+  heuristics = std::make_shared<Heuristics>(hash_size_mb);
   set_position(chess::Board::initial());
 }
 
@@ -28,8 +40,26 @@ void Engine::Impl::apply_move(const chess::Move& move) {
   repetition_tracker.push(current_position, move);
 }
 
+void Engine::Impl::set_hash_size(size_t size_mb) {
+  // An ongoing search keeps its own heuristics, so they are replaced instead of resized. If the new table cannot be
+  // allocated, the old heuristics and size are kept.
+  heuristics = std::make_shared<Heuristics>(size_mb);
+  hash_size_mb = size_mb;
+}
+
+void Engine::Impl::load_opening_book(const std::filesystem::path& path) { opening_book.emplace(path); }
+
+std::optional<chess::Move> Engine::Impl::get_book_move() {
+  if (!opening_book) return std::nullopt;
+  return opening_book->choose_move(current_position, random);
+}
+
+void Engine::Impl::load_tablebases(const std::filesystem::path& directory) {
+  tablebases = std::make_shared<const chess::Tablebases>(chess::Tablebases::load_directory(directory));
+}
+
 std::shared_ptr<engine::Search> Engine::Impl::search(engine::uci::SearchConfig config) {
-  auto search_impl{
-      std::make_unique<engine::Search::Impl>(current_position, repetition_tracker, heuristics, std::move(config))};
+  auto search_impl{std::make_unique<engine::Search::Impl>(current_position, repetition_tracker, heuristics, tablebases,
+                                                          std::move(config))};
   return engine::Search::Impl::to_search(std::move(search_impl));
 }
\ No newline at end of file
@@ -1,9 +1,15 @@
 #pragma once
 
+#include <cstddef>
+#include <filesystem>
 #include <memory>
+#include <optional>
+#include <random>
 
 #include "chess/board.h"
-#include "chess/stack_repetition_tracker.h"
+#include "chess/fixed_repetition_tracker.h"
+#include "chess/opening_book.h"
+#include "chess/tablebase.h"
 #include "engine.h"
 #include "heuristics.h"
 
@@ -20,12 +26,29 @@ public:
   // Apply the given move to the board.
   void apply_move(const chess::Move& move);
 
+  // Resizes the transposition table to the given size in MiB, which clears it along with all other heuristics.
+  void set_hash_size(size_t size_mb);
+
+  // Maps the opening book at the given path.
+  void load_opening_book(const std::filesystem::path& path);
+
+  // Returns a random book move for the current position, if any.
+  std::optional<chess::Move> get_book_move();
+
+  // Loads the endgame tablebases in the given directory.
+  void load_tablebases(const std::filesystem::path& directory);
+
   // Performs a search with configurations based on the uci go command.
   // The search can be interacted with through the returned Search object.
   std::shared_ptr<engine::Search> search(engine::uci::SearchConfig config);
 
 private:
   chess::Board current_position;
-  chess::StackRepetitionTracker repetition_tracker;
+  chess::FixedRepetitionTracker repetition_tracker;
+  size_t hash_size_mb;  // Size of the transposition table.
   std::shared_ptr<Heuristics> heuristics;
+  // Shared with searches, as tablebases are never modified once loaded. This is null if none were loaded.
+  std::shared_ptr<const chess::Tablebases> tablebases;
+  std::optional<chess::OpeningBook> opening_book;
+  std::mt19937_64 random;  // Chooses between book moves.
 };
\ No newline at end of file
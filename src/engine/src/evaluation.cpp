@@ -3,6 +3,9 @@
 #include <algorithm>
 #include <array>
 #include <cstdint>
+#include <optional>
+
+#include "chess/kpk.h"
 
 // Values for the Piece Square Tables are taken from
 // https://www.chessprogramming.org/PeSTO%27s_Evaluation_Function
@@ -212,6 +215,34 @@ Evaluation Evaluation::evaluate(const chess::Board &board) {
   return Evaluation{board.is_white_to_move() ? evaluation : static_cast<int16_t>(-evaluation)};
 }
 
+// Evaluation of an endgame that is known to be won (without a mate being found yet), before any bonus.
+constexpr int16_t known_win{5'000};
+
+std::optional<Evaluation> Evaluation::evaluate_kpk(const chess::Board &board) {
+  const std::optional<bool> is_win{chess::kpk::probe(board)};
+  if (!is_win) return std::nullopt;
+  if (!*is_win) return draw;
+
+  const chess::Bitboard white_pawn{board.get_player<chess::Color::White>()[chess::PieceType::Pawn]};
+  const chess::Bitboard pawn{white_pawn ? white_pawn : board.get_player<chess::Color::Black>()[chess::PieceType::Pawn]};
+  const int rank{pawn.to_index() / 8};
+  const int relative_rank{white_pawn ? rank : 7 - rank};
+  const Evaluation win{static_cast<int16_t>(known_win + piece[static_cast<size_t>(chess::PieceType::Pawn)].value *
+                                                            relative_rank)};
+  return board.is_white_to_move() == static_cast<bool>(white_pawn) ? win : -win;
+}
+
+Evaluation Evaluation::from_tablebase(const chess::TablebaseResult& result, int32_t depth) {
+  switch (result.wdl) {
+    case chess::Wdl::Win:
+      return winning(depth - result.plies_to_mate);
+    case chess::Wdl::Loss:
+      return losing(depth - result.plies_to_mate);
+    default:
+      return draw;
+  }
+}
+
 Evaluation Evaluation::winning(int32_t depth) { return Evaluation{static_cast<int16_t>(20'000 + depth)}; }
 
 Evaluation Evaluation::losing(int32_t depth) { return Evaluation{static_cast<int16_t>(-20'000 - depth)}; }
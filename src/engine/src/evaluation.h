@@ -2,9 +2,11 @@
 
 #include <array>
 #include <cstdint>
+#include <optional>
 
 #include "chess/board.h"
 #include "chess/pieces/base_piece.h"
+#include "chess/tablebase.h"
 
 class Evaluation {
 public:
@@ -15,6 +17,15 @@ public:
   // Higher evaluation is better.
   [[nodiscard]] static Evaluation evaluate(const chess::Board& board);
 
+  // Returns the exact evaluation of the given board from the perspective of the current player if it is a king and
+  // pawn vs king endgame (see chess::kpk). Wins are scored below mates, and higher the further the pawn has advanced,
+  // so that the search still makes progress towards promoting it.
+  [[nodiscard]] static std::optional<Evaluation> evaluate_kpk(const chess::Board& board);
+
+  // Returns the evaluation of a tablebase result (see chess::Tablebases) of a position at some `depth`, where mates are
+  // scored the same as if they were found `plies_to_mate` plies deeper.
+  [[nodiscard]] static Evaluation from_tablebase(const chess::TablebaseResult& result, int32_t depth);
+
   static const Evaluation draw;
 
   // Lowerbound for evaluations (need not be reachable).
@@ -1,15 +1,27 @@
 #pragma once
 
+#include <cstddef>
+#include <memory>
 #include <mutex>
+#include <vector>
 
+#include "config.h"
 #include "history_heuristic.h"
 #include "killer_moves.h"
 #include "transposition_table.h"
 
-// A struct to aggregate all the data used for various heuristics during search.
-struct Heuristics {
+// Heuristics that are owned by a single search thread, so that threads never contend for them.
+struct ThreadHeuristics {
   KillerMoves killer_moves;
-  TranspositionTable transposition_table;
   HistoryHeuristic history_heuristic;
+};
+
+// A struct to aggregate all the data used for various heuristics during search.
+struct Heuristics {
+  explicit Heuristics(size_t hash_size_mb = config::default_hash_size_mb) : transposition_table{hash_size_mb} {}
+
+  TranspositionTable transposition_table;  // Shared by all threads of a search, without locks.
+  // Heuristics of each search thread (by index), which are kept between searches.
+  std::vector<std::unique_ptr<ThreadHeuristics>> thread_heuristics;
   std::mutex mutex;  // Any access to the data should lock this mutex first.
 };
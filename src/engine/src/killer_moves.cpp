@@ -20,3 +20,5 @@ void KillerMoves::clear() {
 }
 
 const chess::Move& KillerMoves::get(int depth_left, int index) const { return killer_moves[depth_left][index]; }
+
+std::span<const chess::Move> KillerMoves::get_all(int depth_left) const { return killer_moves[depth_left]; }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <span>
 
 #include "chess/move.h"
 #include "config.h"
@@ -20,6 +21,9 @@ public:
   // Returns the killer move at the given `depth_left` and index.
   const chess::Move& get(int depth_left, int index) const;
 
+  // Returns all killer moves at the given `depth_left`, from most to least recent.
+  std::span<const chess::Move> get_all(int depth_left) const;
+
 private:
   std::array<std::array<chess::Move, KillerMoves::count>, config::max_depth> killer_moves;
 };
\ No newline at end of file
@@ -13,6 +13,8 @@ namespace move_priority {
 constexpr int32_t hash_move{1'000'000};
 
 constexpr int32_t capture{400'000};
+// Captures that lose material by static exchange evaluation are only ordered by MVV LVA, after the other captures.
+constexpr int32_t losing_capture{0};
 
 // Ordered by most valuable victim, then least valuable attacker. Indexed by [victim][attacker].
 constexpr std::array<std::array<int32_t, 6>, 7> mvv_lva{[]() {
@@ -57,16 +59,21 @@ constexpr int killer_index{1};  // To prioritise more recent killer moves.
 constexpr int32_t history_heuristic_scale = {100'000};
 }  // namespace move_priority
 
-MovePriority MovePriority::evaluate(const chess::Move& move, int32_t depth_left, const chess::Move& hash_move,
-                                    chess::Color player_color, Heuristics& heuristics) {
+MovePriority MovePriority::evaluate(const chess::Board& board, const chess::Move& move,
+                                    chess::StagedMoveGen::Stage stage, int32_t depth_left, const chess::Move& hash_move,
+                                    ThreadHeuristics& heuristics) {
   if (move == hash_move) return MovePriority{move_priority::hash_move};
 
   int32_t priority = 0;
 
   if (move.is_capture()) {
-    // MVV LVA priority.
+    // MVV LVA priority, with losing captures after all other captures. The staged move generator already split the
+    // captures by static exchange evaluation (leaving the losing ones for its last stage), except for evasions.
+    using Stage = chess::StagedMoveGen::Stage;
+    const bool is_losing_capture{stage == Stage::Evasions ? board.see(move) < 0
+                                                          : stage == Stage::QuietMovesAndBadCaptures};
     priority +=
-        move_priority::capture +
+        (is_losing_capture ? move_priority::losing_capture : move_priority::capture) +
         move_priority::mvv_lva[static_cast<size_t>(move.get_captured_piece())][static_cast<size_t>(move.get_piece())];
   }
 
@@ -86,7 +93,7 @@ MovePriority MovePriority::evaluate(const chess::Move& move, int32_t depth_left,
     }
 
     if (!is_killer) {
-      priority += heuristics.history_heuristic.get_ratio(player_color, move.get_from(), move.get_to()) *
+      priority += heuristics.history_heuristic.get_ratio(board.get_color(), move.get_from(), move.get_to()) *
                   move_priority::history_heuristic_scale;
     }
   }
@@ -2,8 +2,10 @@
 
 #include <cstdint>
 
+#include "chess/board.h"
 #include "chess/color.h"
 #include "chess/move.h"
+#include "chess/move_gen.h"
 #include "heuristics.h"
 
 // Higher priority moves should be searched first.
@@ -11,9 +13,11 @@ class MovePriority {
 public:
   constexpr auto operator<=>(const MovePriority& other) const = default;
 
-  // Returns the priority level of a move.
-  [[nodiscard]] static MovePriority evaluate(const chess::Move& move, int32_t depth_left, const chess::Move& hash_move,
-                                             chess::Color player_color, Heuristics& heuristics);
+  // Returns the priority level of a move on the given board, which was generated by the given stage of a
+  // `chess::StagedMoveGen` (the stage tells whether a capture loses material, except for evasions).
+  [[nodiscard]] static MovePriority evaluate(const chess::Board& board, const chess::Move& move,
+                                             chess::StagedMoveGen::Stage stage, int32_t depth_left,
+                                             const chess::Move& hash_move, ThreadHeuristics& heuristics);
 
   // Returns the priority level of a quiescence move.
   [[nodiscard]] static MovePriority evaluate_quiescence(const chess::Move& move);
@@ -1,28 +1,38 @@
 #include "search_impl.h"
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <chrono>
 #include <mutex>
+#include <optional>
+#include <vector>
 
+#include "chess/board_info.h"
+#include "chess/constants.h"
+#include "chess/move_gen.h"
 #include "config.h"
 #include "evaluation.h"
 #include "move_priority.h"
 #include "time_management.h"
 #include "uci.h"
 
-engine::Search::Impl::Impl(chess::Board position_, chess::StackRepetitionTracker repetition_tracker_,
-                           std::shared_ptr<Heuristics> heuristics_, engine::uci::SearchConfig config_)
+engine::Search::Impl::Impl(chess::Board position_, chess::FixedRepetitionTracker repetition_tracker_,
+                           std::shared_ptr<Heuristics> heuristics_,
+                           std::shared_ptr<const chess::Tablebases> tablebases_, engine::uci::SearchConfig config_)
     : starting_position{std::move(position_)},
       repetition_tracker{std::move(repetition_tracker_)},
+      root_ply{repetition_tracker.ply()},
       heuristics{std::move(heuristics_)},
+      tablebases{std::move(tablebases_)},
       config{std::move(config_)},
       stop_signal{false},
-      stopped{false},
       done{false},
       search_thread{},
       best_move{chess::Move::null()},
       debug_info{},
-      root_depth{1},
-      time_management{config, starting_position.get_color()} {
+      time_management{config, starting_position.get_color()},
+      workers{} {
   //! TODO: support time controls (wtime, btime, winc, binc).
   //! TODO: support nodes <x>
   //! TODO: support searchmoves
@@ -34,6 +44,12 @@ engine::Search::Impl::Impl(chess::Board position_, chess::StackRepetitionTracker
   //! Ideally there should be some API to try_search() that returns immediately on failing to lock,
   //! or some mechanism in the Engine to prevent concurrent searches.
 
+  this->heuristics->transposition_table.new_search();  // Entries stored by previous searches age.
+  const size_t thread_count{std::max<size_t>(config.threads, 1)};
+  auto& thread_heuristics{this->heuristics->thread_heuristics};
+  while (thread_heuristics.size() < thread_count) thread_heuristics.push_back(std::make_unique<ThreadHeuristics>());
+  for (size_t i{0}; i < thread_count; i++) workers.push_back(std::make_unique<Worker>(*this, i, *thread_heuristics[i]));
+
   // Set the best move to any move in case we timeout before searching.
   best_move = [&]() {
     if (auto moves{starting_position.generate_moves()}; !moves.empty()) return moves[0];
@@ -71,36 +87,86 @@ std::shared_ptr<engine::Search> engine::Search::Impl::to_search(std::unique_ptr<
 }
 
 void engine::Search::Impl::go(std::unique_lock<std::mutex>) {
-  const int32_t max_search_depth{config.depth.value_or(config::max_depth)};
+  std::vector<std::thread> helper_threads;
+  for (size_t i{1}; i < workers.size(); i++) helper_threads.emplace_back([this, i]() { workers[i]->go(); });
+  workers[0]->go();
+  // Helper threads only stop on their own once the cutoff time is reached, so they are signalled in case the main
+  // thread completed its last iteration earlier.
+  stop();
+  for (std::thread& helper_thread : helper_threads) helper_thread.join();
+
+  // Take the result of the deepest completed iteration, which is usually the main thread's. A helper thread may have
+  // completed a deeper iteration, as it skips depths and finds its positions in the transposition table too.
+  const Worker* best_worker{workers[0].get()};
+  for (const auto& worker : workers) {
+    if (worker->get_debug_info().search_depth > best_worker->get_debug_info().search_depth) best_worker = worker.get();
+  }
+  if (!best_worker->get_best_move().is_null()) best_move = best_worker->get_best_move();
+  debug_info = best_worker->get_debug_info();
+  debug_info.timed_out = workers[0]->get_debug_info().timed_out;
+  for (const auto& worker : workers) {
+    if (worker.get() == best_worker) continue;
+    const DebugInfo& worker_info{worker->get_debug_info()};
+    debug_info.normal_node_count += worker_info.normal_node_count;
+    debug_info.quiescence_node_count += worker_info.quiescence_node_count;
+    debug_info.null_move_success += worker_info.null_move_success;
+    debug_info.null_move_total += worker_info.null_move_total;
+    debug_info.transposition_table_success += worker_info.transposition_table_success;
+    debug_info.transposition_table_total += worker_info.transposition_table_total;
+    debug_info.q_delta_pruning_success += worker_info.q_delta_pruning_success;
+    debug_info.q_delta_pruning_total += worker_info.q_delta_pruning_total;
+  }
+  debug_info.hashfull = heuristics->transposition_table.get_hashfull();
+  debug_info.time_spent = time_management.time_spent();
+  done.store(true, std::memory_order::release);
+  done.notify_all();
+}
+
+engine::Search::Impl::Worker::Worker(Impl& impl, size_t index, ThreadHeuristics& heuristics)
+    : impl{impl},
+      index{index},
+      repetition_tracker{impl.repetition_tracker},
+      heuristics{heuristics},
+      transposition_table{impl.heuristics->transposition_table},
+      stopped{false},
+      best_move{chess::Move::null()},
+      debug_info{},
+      root_depth{1} {}
+
+void engine::Search::Impl::Worker::go() {
+  const int32_t max_search_depth{impl.config.depth.value_or(config::max_depth)};
   while (root_depth <= max_search_depth) {
-    chess::Move found_move{iterative_deepening()};
-    if (found_move.is_null()) {
-      debug_info.timed_out = true;
-      break;
+    if (!should_skip_depth()) {
+      chess::Move found_move{iterative_deepening()};
+      if (found_move.is_null()) {
+        debug_info.timed_out = true;
+        break;
+      }
+      debug_info.search_depth = root_depth;
+      best_move = std::move(found_move);
     }
-    debug_info.search_depth = root_depth;
-    best_move = std::move(found_move);
     root_depth++;
-    if (!time_management.can_continue_iteration()) {
+    if (index == 0 && !impl.time_management.can_continue_iteration()) {
       if (root_depth <= max_search_depth) debug_info.timed_out = true;
       break;
     }
   }
-  debug_info.time_spent = time_management.time_spent();
-  done.store(true, std::memory_order::release);
-  done.notify_all();
 }
 
-chess::Move engine::Search::Impl::iterative_deepening() {
+chess::Move engine::Search::Impl::Worker::get_best_move() const { return best_move; }
+
+const engine::Search::DebugInfo& engine::Search::Impl::Worker::get_debug_info() const { return debug_info; }
+
+chess::Move engine::Search::Impl::Worker::iterative_deepening() {
   reset_iteration();
-  const auto [evaluation, best_move] = search(starting_position, Evaluation::min, Evaluation::max, root_depth);
+  const auto [evaluation, best_move] = search(impl.starting_position, Evaluation::min, Evaluation::max, root_depth);
   if (should_stop()) return chess::Move::null();
   debug_info.evaluation = evaluation.to_centipawns();
   return best_move;
 }
 
-std::pair<Evaluation, chess::Move> engine::Search::Impl::search(const chess::Board& board, Evaluation alpha,
-                                                                Evaluation beta, int32_t depth_left) {
+std::pair<Evaluation, chess::Move> engine::Search::Impl::Worker::search(const chess::Board& board, Evaluation alpha,
+                                                                        Evaluation beta, int32_t depth_left) {
   if (depth_left <= 0) {
     // Switch to quiescence search
     return {quiescence_search(board, alpha, beta, 0), chess::Move::null()};
@@ -111,19 +177,44 @@ std::pair<Evaluation, chess::Move> engine::Search::Impl::search(const chess::Boa
     return {Evaluation::draw, chess::Move::null()};
   }
 
-  if (const auto score{board.get_score(repetition_tracker)}) {
-    if (*score == 0) return {Evaluation::draw, chess::Move::null()};
-    else return {Evaluation::losing(depth_left), chess::Move::null()};
+  // Checkmate and stalemate are only detected once no legal move is generated below, so that move generation is not
+  // done twice at every node.
+  if (repetition_tracker.is_repetition_draw() ||
+      board.get_halfmove_clock() >= chess::constants::fifty_move_rule_plies) {
+    return {Evaluation::draw, chess::Move::null()};
+  }
+
+  // Endgames in the tablebases, and king and pawn vs king endgames, are looked up instead of searched (except at the
+  // root, where a move is needed).
+  if (depth_left < root_depth) {
+    if (const std::optional<Evaluation> tablebase_evaluation{probe_tablebases(board, depth_left)}) {
+      return {*tablebase_evaluation, chess::Move::null()};
+    }
+    if (const std::optional<Evaluation> kpk_evaluation{Evaluation::evaluate_kpk(board)}) {
+      return {*kpk_evaluation, chess::Move::null()};
+    }
+  }
+
+  // If the current player can repeat a position, then the position is at least a draw for them.
+  if (depth_left < root_depth && alpha < Evaluation::draw &&
+      repetition_tracker.has_upcoming_repetition(board, repetition_tracker.ply() - impl.root_ply)) {
+    alpha = Evaluation::draw;
+    if (alpha >= beta) return {alpha, chess::Move::null()};
   }
 
+  // Computed once, as it is needed to check whether we are in check and to generate moves.
+  const chess::BoardInfo board_info{board};
+
   const chess::Board::Hash board_hash = board.get_hash();
   NodeType node_type{NodeType::All};  // Assume all-node unless a good enough move is found.
   chess::Move best_move{};
 
   // Check transposition table.
   chess::Move hash_move{};
-  if (const PositionInfo * info{heuristics->transposition_table.get(board_hash)}; info && depth_left < root_depth) {
-    if (info->depth_left >= depth_left) {
+  if (const std::optional<PositionInfo> info{transposition_table.get(board_hash)}) {
+    // The root is always searched (as a move is needed), but its hash move from the previous iteration is still tried
+    // first.
+    if (depth_left < root_depth && info->depth_left >= depth_left) {
       // We have seen this position before and analyzed it to at least the same depth.
       debug_info.transposition_table_total++;
 
@@ -146,7 +237,7 @@ std::pair<Evaluation, chess::Move> engine::Search::Impl::search(const chess::Boa
       }
     }
 
-    hash_move = info->best_move;
+    hash_move = info->get_best_move(board);
   }
 
   // Null move heuristic (https://www.chessprogramming.org/Null_Move_Pruning).
@@ -155,100 +246,140 @@ std::pair<Evaluation, chess::Move> engine::Search::Impl::search(const chess::Boa
   // 2. There is at least R depth left.
   // 3. Beta is not completely winning.
   // 4. Static evalution of current position is >= beta.
-  const bool is_in_check{board.is_in_check()};
+  const bool is_in_check{board_info.is_in_check()};
   if (depth_left < root_depth && !is_in_check && depth_left >= config::null_move_heuristic_R + 1 &&
       !beta.is_winning() && Evaluation::evaluate(board) >= beta) {
     debug_info.null_move_total++;
     chess::Board new_board{board.skip_turn()};
+    transposition_table.prefetch(new_board.get_hash());
+    repetition_tracker.push(new_board);
     Evaluation null_move_evaluation =
         -search(new_board, -beta, (-beta).succ(), depth_left - 1 - config::null_move_heuristic_R).first;
+    repetition_tracker.pop();
     if (null_move_evaluation >= beta) {
       debug_info.null_move_success++;
       return {beta, chess::Move::null()};
     }
   }
 
-  chess::MoveContainer moves = board.generate_moves();
-  std::vector<MovePriority> move_priorities;
-  move_priorities.reserve(moves.size());
-  for (const auto& move : moves) {
-    move_priorities.push_back(MovePriority::evaluate(move, depth_left, hash_move, board.get_color(), *heuristics));
-  }
-
   // Only used for futility pruning.
   Evaluation cur_board_evaluation{};
   if (depth_left == 1) cur_board_evaluation = Evaluation::evaluate(board);
 
-  for (size_t i = 0; i < moves.size(); i++) {
-    MovePriority best_priority = move_priorities[i];
-    size_t best_index = i;
-    for (size_t j = i + 1; j < moves.size(); j++) {
-      if (move_priorities[j] > best_priority) {
-        best_priority = move_priorities[j];
-        best_index = j;
-      }
+  // Moves are generated in stages (hash move, good captures, killers, then quiets and bad captures), so that later
+  // stages are never generated if an earlier move causes a beta-cutoff.
+  chess::StagedMoveGen staged_move_gen{board_info, hash_move, heuristics.killer_moves.get_all(depth_left)};
+  chess::MoveContainer moves;
+  std::vector<MovePriority> move_priorities;
+  bool has_moves{false};
+  bool has_searched_move{false};
+  while (node_type != NodeType::Cut && staged_move_gen.next_stage(moves)) {
+    has_moves = true;
+    move_priorities.clear();
+    const chess::StagedMoveGen::Stage stage{staged_move_gen.get_stage()};
+    for (const auto& move : moves) {
+      move_priorities.push_back(MovePriority::evaluate(board, move, stage, depth_left, hash_move, heuristics));
     }
-    std::swap(moves[i], moves[best_index]);
-    std::swap(move_priorities[i], move_priorities[best_index]);
 
-    // Futility pruning. If the expected value of this move does not raise the evaluation above alpha, then it is
-    // likely not worth it to try it out.
-    if (depth_left == 1 && !is_in_check && !beta.is_winning() && !alpha.is_losing()) {
-      Evaluation move_value_estimate{};
-      if (moves[i].get_captured_piece() != chess::PieceType::None) {
-        move_value_estimate += Evaluation::piece[static_cast<size_t>(moves[i].get_captured_piece())];
+    for (size_t i = 0; i < moves.size(); i++) {
+      MovePriority best_priority = move_priorities[i];
+      size_t best_index = i;
+      for (size_t j = i + 1; j < moves.size(); j++) {
+        if (move_priorities[j] > best_priority) {
+          best_priority = move_priorities[j];
+          best_index = j;
+        }
       }
-      if (moves[i].get_promotion_piece() != chess::PieceType::None) {
-        move_value_estimate += Evaluation::piece[static_cast<size_t>(moves[i].get_promotion_piece())];
+      // The best move is rotated into place rather than swapped, so that moves of equal priority keep the order they
+      // were generated in, however the moves are split into stages.
+      std::rotate(moves.begin() + i, moves.begin() + best_index, moves.begin() + best_index + 1);
+      std::rotate(move_priorities.begin() + i, move_priorities.begin() + best_index,
+                  move_priorities.begin() + best_index + 1);
+
+      // Futility pruning. If the expected value of this move does not raise the evaluation above alpha, then it is
+      // likely not worth it to try it out.
+      if (depth_left == 1 && !is_in_check && !beta.is_winning() && !alpha.is_losing()) {
+        Evaluation move_value_estimate{};
+        if (moves[i].get_captured_piece() != chess::PieceType::None) {
+          move_value_estimate += Evaluation::piece[static_cast<size_t>(moves[i].get_captured_piece())];
+        }
+        if (moves[i].get_promotion_piece() != chess::PieceType::None) {
+          move_value_estimate += Evaluation::piece[static_cast<size_t>(moves[i].get_promotion_piece())];
+        }
+        if (cur_board_evaluation + move_value_estimate + config::futility_margin <= alpha) {
+          continue;
+        }
       }
-      if (cur_board_evaluation + move_value_estimate + config::futility_margin <= alpha) {
-        continue;
+
+      const chess::Board new_board{board.apply_move(moves[i])};
+      // The child probes the transposition table only after checking for draws and tablebase positions, so its bucket
+      // is fetched now to overlap the cache miss with that work. Quiescence search does not probe the table.
+      if (depth_left > 1) transposition_table.prefetch(new_board.get_hash());
+      repetition_tracker.push(new_board, moves[i]);
+      //! TODO: Late Move Reduction was removed because it was pruning good lines and causing testcases to fail.
+      //! Figure out how to implement it correctly.
+      // Principal variation search (https://www.chessprogramming.org/Principal_Variation_Search): as moves are ordered
+      // best first, the moves after the first are expected to fail low, which is proven more cheaply with a null
+      // window. Only a move that unexpectedly raises alpha is searched again with the full window.
+      Evaluation new_board_evaluation;
+      if (!has_searched_move) {
+        new_board_evaluation = -search(new_board, -beta, -alpha, depth_left - 1).first;
+      } else {
+        new_board_evaluation = -search(new_board, -alpha.succ(), -alpha, depth_left - 1).first;
+        if (new_board_evaluation > alpha && new_board_evaluation < beta) {
+          new_board_evaluation = -search(new_board, -beta, -alpha, depth_left - 1).first;
+        }
+      }
+      has_searched_move = true;
+      repetition_tracker.pop();
+
+      if (new_board_evaluation >= beta) {
+        alpha = beta;
+        best_move = moves[i];
+        node_type = NodeType::Cut;
+        heuristics.history_heuristic.add_move_success(board.is_white_to_move(), moves[i].get_from(), moves[i].get_to());
+        break;
+      }
+      heuristics.history_heuristic.add_move_failure(board.is_white_to_move(), moves[i].get_from(), moves[i].get_to());
+      if (new_board_evaluation > alpha) {
+        alpha = new_board_evaluation;
+        best_move = moves[i];
+        node_type = NodeType::PV;
       }
     }
+  }
 
-    const chess::Board new_board{board.apply_move(moves[i])};
-    repetition_tracker.push(new_board, moves[i]);
-    //! TODO: Late Move Reduction was removed because it was pruning good lines and causing testcases to fail.
-    //! Figure out how to implement it correctly.
-    const Evaluation new_board_evaluation{-search(new_board, -beta, -alpha, depth_left - 1).first};
-    repetition_tracker.pop();
-
-    if (new_board_evaluation >= beta) {
-      alpha = beta;
-      best_move = moves[i];
-      node_type = NodeType::Cut;
-      heuristics->history_heuristic.add_move_success(board.is_white_to_move(), moves[i].get_from(), moves[i].get_to());
-      break;
-    }
-    heuristics->history_heuristic.add_move_failure(board.is_white_to_move(), moves[i].get_from(), moves[i].get_to());
-    if (new_board_evaluation > alpha) {
-      alpha = new_board_evaluation;
-      best_move = moves[i];
-      node_type = NodeType::PV;
-    }
+  if (!has_moves) {
+    if (is_in_check) return {Evaluation::losing(depth_left), chess::Move::null()};  // Checkmate.
+    return {Evaluation::draw, chess::Move::null()};                                // Stalemate.
   }
 
   if (node_type == NodeType::Cut && !best_move.is_capture()) {
     // Add new killer move if beta-cutoff caused by non-capture.
-    heuristics->killer_moves.add(best_move, depth_left);
+    heuristics.killer_moves.add(best_move, depth_left);
   }
 
-  heuristics->transposition_table.try_update(board_hash, depth_left, best_move, node_type, alpha);
+  transposition_table.try_update(board_hash, depth_left, best_move, node_type, alpha);
 
   return {alpha, best_move};
 }
 
-Evaluation engine::Search::Impl::quiescence_search(const chess::Board& board, Evaluation alpha, Evaluation beta,
-                                                   int32_t depth_left) {
+Evaluation engine::Search::Impl::Worker::quiescence_search(const chess::Board& board, Evaluation alpha,
+                                                           Evaluation beta, int32_t depth_left) {
   debug_info.quiescence_node_count++;
   if (should_stop()) return Evaluation::draw;
 
-  if (const auto score{board.get_score(repetition_tracker)}) {
-    if (*score == 0) return Evaluation::draw;
-    return Evaluation::losing(depth_left);  // Checkmate, minus depth_left so that shorter mates are preferred.
+  if (repetition_tracker.is_repetition_draw() ||
+      board.get_halfmove_clock() >= chess::constants::fifty_move_rule_plies) {
+    return Evaluation::draw;
   }
 
-  bool is_in_check{board.is_in_check()};
+  if (const std::optional<Evaluation> tablebase_evaluation{probe_tablebases(board, depth_left)}) {
+    return *tablebase_evaluation;
+  }
+  if (const std::optional<Evaluation> kpk_evaluation{Evaluation::evaluate_kpk(board)}) return *kpk_evaluation;
+
+  const bool is_in_check{board.is_in_check()};
   if (!is_in_check && depth_left <= -config::quiescence_search_depth) return Evaluation::evaluate(board);
 
   const Evaluation board_evaluation{Evaluation::evaluate(board)};
@@ -268,10 +399,19 @@ Evaluation engine::Search::Impl::quiescence_search(const chess::Board& board, Ev
     alpha = std::max(alpha, board_evaluation);
   }
 
-  chess::MoveContainer moves{[&board, is_in_check]() {
-    if (is_in_check) return board.generate_moves();
-    return board.generate_quiescence_moves();
-  }()};
+  // When in check, all legal evasions are generated, and checkmate is detected in the same pass. Otherwise, captures
+  // are generated pseudo-legally, as most of them are pruned below, and only the moves that are tried are checked for
+  // legality. Stalemate is not detected when standing pat above, as that would cost a move generation at every node.
+  chess::MoveContainer moves;
+  if (is_in_check) {
+    auto [evasions, score] = chess::move_gen::generate_moves_and_score(board);
+    // Checkmate, minus depth_left so that shorter mates are preferred.
+    if (score) return Evaluation::losing(depth_left);
+    moves = std::move(evasions);
+  } else {
+    moves = chess::move_gen::generate_pseudo_legal_quiescence_moves(board);
+  }
+  bool has_tried_moves{false};
 
   std::vector<MovePriority> move_priorities;
   move_priorities.reserve(moves.size());
@@ -291,6 +431,9 @@ Evaluation engine::Search::Impl::quiescence_search(const chess::Board& board, Ev
     std::swap(moves[i], moves[best_index]);
     std::swap(move_priorities[i], move_priorities[best_index]);
 
+    // Skip moves that lose material by static exchange evaluation, as the opponent could simply recapture.
+    if (!is_in_check && board.see(moves[i]) < 0) continue;
+
     // Delta pruning. If capturing a piece (+ some safety value) does not raise evaluation above alpha, then there is
     // likely no point in checking this move at all.
     if (!is_in_check && moves[i].is_capture()) {
@@ -306,6 +449,9 @@ Evaluation engine::Search::Impl::quiescence_search(const chess::Board& board, Ev
       }
     }
 
+    if (!is_in_check && !chess::move_gen::is_pseudo_legal_move_legal(board, moves[i])) continue;
+    has_tried_moves = true;
+
     chess::Board new_board = board.apply_move(moves[i]);
     repetition_tracker.push(new_board, moves[i]);
     Evaluation new_board_evaluation = -quiescence_search(new_board, -beta, -alpha, depth_left - 1);
@@ -314,23 +460,55 @@ Evaluation engine::Search::Impl::quiescence_search(const chess::Board& board, Ev
     alpha = std::max(alpha, new_board_evaluation);
   }
 
+  if (!has_tried_moves && !board.has_moves()) return Evaluation::draw;  // Stalemate.
   return alpha;
 }
 
-void engine::Search::Impl::reset_iteration() {
+std::optional<Evaluation> engine::Search::Impl::Worker::probe_tablebases(const chess::Board& board,
+                                                                         int32_t depth_left) const {
+  const chess::Tablebases* const tablebases{impl.tablebases.get()};
+  if (!tablebases) return std::nullopt;
+  const chess::Bitboard occupied{board.get_player<chess::Color::White>().occupied() |
+                                 board.get_player<chess::Color::Black>().occupied()};
+  if (occupied.count() > tablebases->get_max_piece_count()) return std::nullopt;
+  const std::optional<chess::TablebaseResult> result{tablebases->probe(board)};
+  if (!result) return std::nullopt;
+  return Evaluation::from_tablebase(*result, depth_left);
+}
+
+void engine::Search::Impl::Worker::reset_iteration() {
   // Reset killer moves between each iteration of iterative deepening.
-  heuristics->killer_moves.clear();
+  heuristics.killer_moves.clear();
+}
+
+bool engine::Search::Impl::Worker::should_skip_depth() const {
+  if (index == 0) return false;
+  // Each helper thread alternates between searching and skipping runs of `skip_size` depths, with its runs offset by
+  // `skip_phase`, so that threads are spread over the next few depths.
+  constexpr std::array<int32_t, 20> skip_size{1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+  constexpr std::array<int32_t, 20> skip_phase{0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+  const size_t i{(index - 1) % skip_size.size()};
+  return (root_depth + skip_phase[i]) / skip_size[i] % 2 != 0;
 }
 
-bool engine::Search::Impl::should_stop() {
+bool engine::Search::Impl::Worker::should_stop() {
   if (stopped) return true;
 
+  // Only the main thread manages time, but helper threads also stop the search once the cutoff time is reached, as the
+  // main thread may be waiting for a core and notice the cutoff late.
   const int64_t visited_nodes_count{debug_info.normal_node_count + debug_info.quiescence_node_count};
-  if (visited_nodes_count & (time_management.check_interval() - 1)) return false;
-
-  const bool timed_out{time_management.has_timed_out()};
-  const bool stop_signalled{stop_signal.load(std::memory_order::acquire)};
-  if (timed_out || stop_signalled) stopped = true;
+  // The main thread checks the time more often when there are helper threads, as they may share its core and slow it
+  // down (the interval stays a power of two).
+  const int64_t thread_count{static_cast<int64_t>(std::bit_floor(impl.workers.size()))};
+  const int64_t check_interval{index == 0 ? std::max<int64_t>(impl.time_management.check_interval() / thread_count, 1)
+                                          : config::helper_check_interval};
+  if (visited_nodes_count & (check_interval - 1)) return false;
+
+  if (index == 0 ? impl.time_management.has_timed_out() : impl.time_management.is_past_cutoff()) {
+    // Signal the other threads right away, so that they stop while this thread unwinds its search.
+    impl.stop();
+  }
+  if (impl.stop_signal.load(std::memory_order::acquire)) stopped = true;
 
   return stopped;
-}
\ No newline at end of file
+}
@@ -1,10 +1,13 @@
 #include <atomic>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <thread>
 #include <utility>
+#include <vector>
 
-#include "chess/stack_repetition_tracker.h"
+#include "chess/fixed_repetition_tracker.h"
+#include "chess/tablebase.h"
 #include "evaluation.h"
 #include "heuristics.h"
 #include "search.h"
@@ -13,8 +16,9 @@
 
 class engine::Search::Impl {
 public:
-  explicit Impl(chess::Board position_, chess::StackRepetitionTracker repetition_tracker_,
-                std::shared_ptr<Heuristics> heuristics_, engine::uci::SearchConfig config_);
+  explicit Impl(chess::Board position_, chess::FixedRepetitionTracker repetition_tracker_,
+                std::shared_ptr<Heuristics> heuristics_, std::shared_ptr<const chess::Tablebases> tablebases_,
+                engine::uci::SearchConfig config_);
 
   Impl(const Impl&) = delete;
   Impl(Impl&&) = delete;
@@ -38,6 +42,65 @@ public:
   static std::shared_ptr<engine::Search> to_search(std::unique_ptr<Impl> impl);
 
 private:
+  // A thread of the search. Searches use Lazy SMP (https://www.chessprogramming.org/Lazy_SMP): every thread runs
+  // iterative deepening from the same root and shares the transposition table, so that the main thread (index 0) finds
+  // many of its positions already searched by the helper threads. Helper threads skip some depths, so that the threads
+  // are spread over different depths instead of searching the same tree in lockstep.
+  class Worker {
+  public:
+    explicit Worker(Impl& impl, size_t index, ThreadHeuristics& heuristics);
+
+    // Searches deeper until the search stops or the maximum depth is reached.
+    void go();
+
+    // Returns the best move of the deepest completed iteration, or Move::null() if no iteration was completed.
+    chess::Move get_best_move() const;
+
+    // Returns the statistics of this thread, and the results of its deepest completed iteration.
+    const DebugInfo& get_debug_info() const;
+
+  private:
+    Impl& impl;
+    size_t index;  // The main thread has index 0.
+    chess::FixedRepetitionTracker repetition_tracker;
+    // Killer moves and history are local to each thread, which also makes threads order moves differently.
+    ThreadHeuristics& heuristics;
+    TranspositionTable& transposition_table;
+    bool stopped;  // If true, the thread has registered that search should stop.
+    chess::Move best_move;
+    DebugInfo debug_info;
+    int32_t root_depth;
+
+    // Continue traversing the search tree. Returns the evaluation and best move for the current player.
+    // If `timed_out` is true, then the search aborted midway and the results are invalid.
+    // If Move::null was returned as the best move, then it is not known what the best move is (e.g. due to null
+    // pruning).
+    std::pair<Evaluation, chess::Move> search(const chess::Board& board, Evaluation alpha, Evaluation beta,
+                                              int32_t depth_left);
+
+    // Traverse the search tree until a position with no captures or max depth is reached. Returns the evaluation of
+    // the current board for the current player. Note that `depth_left` starts from 0 and decreases, so that all
+    // `depth_left` in quiescence search is lower than in normal search.
+    Evaluation quiescence_search(const chess::Board& board, Evaluation alpha, Evaluation beta, int32_t depth_left);
+
+    // Returns the evaluation of the board from the tablebases, or std::nullopt if it has too many pieces or there are
+    // no tablebases for it.
+    std::optional<Evaluation> probe_tablebases(const chess::Board& board, int32_t depth_left) const;
+
+    // Clears outdated information between each search depth in iterative deepening.
+    void reset_iteration();
+
+    // Search with depth of `root_depth`.
+    // Returns the best move if search completes in time, else returns Move::null().
+    chess::Move iterative_deepening();
+
+    // Returns true if this (helper) thread should skip searching with depth of `root_depth`.
+    bool should_skip_depth() const;
+
+    // Returns true if the search should stop as soon as possible.
+    bool should_stop();
+  };
+
   // Concurrent RW to non-atomic private members is prevented by the `done` member.
   // When `done` is false, the search is ongoing in `search_thread` and will modify the members.
   // At the same time, reads through the public API are blocked.
@@ -45,40 +108,22 @@ private:
   // reads become permitted through the public API.
 
   chess::Board starting_position;
-  chess::StackRepetitionTracker repetition_tracker;
+  chess::FixedRepetitionTracker repetition_tracker;
+  size_t root_ply;  // Number of positions in `repetition_tracker` at the root of the search.
   // This is the only variable not owned by Search::Impl, as it is too costly to copy it per search.
   std::shared_ptr<Heuristics> heuristics;
+  std::shared_ptr<const chess::Tablebases> tablebases;  // Null if no tablebases are loaded.
   engine::uci::SearchConfig config;
-  std::atomic<bool> stop_signal;  // If true, the search has been signalled to stop.
-  bool stopped;                   // If true, the engine has registered that search should stop.
-  std::atomic<bool> done;         // If true, the search has completed.
+  // If true, the search has been signalled to stop. This is also set when the main thread is done, to stop the
+  // helper threads.
+  std::atomic<bool> stop_signal;
+  std::atomic<bool> done;  // If true, the search has completed.
   std::thread search_thread;
   chess::Move best_move;
   DebugInfo debug_info;
-  int32_t root_depth;
-  TimeManagement time_management;
+  TimeManagement time_management;  // Only the main thread calls its non-const methods.
+  std::vector<std::unique_ptr<Worker>> workers;
 
   // Begin searching.
   void go(std::unique_lock<std::mutex> search_lock);
-
-  // Continue traversing the search tree. Returns the evaluation and best move for the current player.
-  // If `timed_out` is true, then the search aborted midway and the results are invalid.
-  // If Move::null was returned as the best move, then it is not known what the best move is (e.g. due to null pruning).
-  std::pair<Evaluation, chess::Move> search(const chess::Board& board, Evaluation alpha, Evaluation beta,
-                                            int32_t depth_left);
-
-  // Traverse the search tree until a position with no captures or max depth is reached. Returns the evaluation of the
-  // current board for the current player. Note that `depth_left` starts from 0 and decreases, so that all `depth_left`
-  // in quiescence search is lower than in normal search.
-  Evaluation quiescence_search(const chess::Board& board, Evaluation alpha, Evaluation beta, int32_t depth_left);
-
-  // Clears outdated information between each search depth in iterative deepening.
-  void reset_iteration();
-
-  // Search with depth of `root_depth`.
-  // Returns the best move if search completes in time, else returns Move::null().
-  chess::Move iterative_deepening();
-
-  // Returns true if the search should stop as soon as possible.
-  bool should_stop();
-};
\ No newline at end of file
+};
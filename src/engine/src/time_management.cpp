@@ -1,12 +1,24 @@
 #include "time_management.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
+#include <tuple>
 #include <utility>
 
 #include "chess/color.h"
 #include "uci.h"
 
+namespace {
+// Time reserved before the deadline for the search to unwind and return its best move.
+constexpr std::chrono::milliseconds base_reserve{2};
+// Time reserved for each helper thread, which only stops the next time it checks the stop signal, and must then be
+// joined. When the threads outnumber the cores, each of them may first have to wait for a time slice.
+constexpr std::chrono::milliseconds helper_thread_reserve{1};
+}  // namespace
+
 // Decide the maximum amount of time to spend searching on the next move.
 // Returns std::nullopt if the search should be indefinite.
 std::optional<std::chrono::milliseconds> decide(const engine::uci::SearchConfig& config, chess::Color player_color) {
@@ -30,16 +42,29 @@ TimeManagement::TimeManagement(const engine::uci::SearchConfig& config, chess::C
     : start_time{std::chrono::steady_clock::now()},
       cutoff_time{std::chrono::steady_clock::time_point::max()},
       previous_iteration_endpoint{start_time},
+      previous_check_time{start_time},
+      max_check_gap{0},
       timeout_danger{TimeoutDanger::Low} {
   if (const auto move_time{decide(config, player_color)}) {
-    // 2ms is a safety buffer to ensure we do not exceed the actual cutoff time.
-    cutoff_time = start_time + move_time.value() - std::chrono::milliseconds{2};
+    // The reserve grows with the number of threads to stop, but is at most half of the time, so that short searches
+    // still search.
+    const size_t helper_count{std::max<size_t>(config.threads, 1) - 1};
+    const std::chrono::milliseconds reserve{
+        std::min(base_reserve + helper_thread_reserve * static_cast<int64_t>(helper_count), move_time.value() / 2)};
+    cutoff_time = start_time + move_time.value() - reserve;
   }
   std::ignore = has_timed_out(start_time);  // Update `timeout_danger`.
 }
 
 bool TimeManagement::has_timed_out(std::chrono::steady_clock::time_point current_time) {
-  if (current_time >= cutoff_time) return true;
+  // Close to the cutoff time, the search also stops if the next check is expected to come after the cutoff time,
+  // judging by the longest time between two checks so far. This scales the reserve with the check interval, and with
+  // how much the helper threads slow down the main thread.
+  if (timeout_danger == TimeoutDanger::High) {
+    max_check_gap = std::max(max_check_gap, current_time - previous_check_time);
+  }
+  previous_check_time = current_time;
+  if (current_time + max_check_gap >= cutoff_time) return true;
 
   if (timeout_danger == TimeoutDanger::Low) {
     if (current_time + std::chrono::milliseconds{100} >= cutoff_time) timeout_danger = TimeoutDanger::Normal;
@@ -51,6 +76,10 @@ bool TimeManagement::has_timed_out(std::chrono::steady_clock::time_point current
   return false;
 }
 
+bool TimeManagement::is_past_cutoff(std::chrono::steady_clock::time_point current_time) const {
+  return current_time >= cutoff_time;
+}
+
 int64_t TimeManagement::check_interval() const {
   // There is no particular reason for these values, other than that they seem to work well enough.
   // The only notable feature is that they are powers of two for faster modulo checking.
@@ -16,6 +16,10 @@ public:
   [[nodiscard]] bool has_timed_out(
       std::chrono::steady_clock::time_point current_time = std::chrono::steady_clock::now());
 
+  // Returns true if the cutoff time has been reached. Unlike `has_timed_out`, this can be called from any thread.
+  [[nodiscard]] bool is_past_cutoff(
+      std::chrono::steady_clock::time_point current_time = std::chrono::steady_clock::now()) const;
+
   // How often `has_timed_out` should be called, every time this number of nodes is visited.
   // The returned value is guaranteed to be a power of two.
   // This number will decrease as we get closer to the cutoff time.
@@ -36,5 +40,9 @@ private:
   std::chrono::steady_clock::time_point start_time;
   std::chrono::steady_clock::time_point cutoff_time;
   std::chrono::steady_clock::time_point previous_iteration_endpoint;
+  std::chrono::steady_clock::time_point previous_check_time;  // Time of the last call to `has_timed_out`.
+  // Longest time between two calls to `has_timed_out` once the danger is high, which is how late the cutoff time may be
+  // noticed.
+  std::chrono::steady_clock::duration max_check_gap;
   enum class TimeoutDanger { Low, Normal, High } timeout_danger;
 };
\ No newline at end of file
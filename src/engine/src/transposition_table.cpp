@@ -1,21 +1,57 @@
 #include "transposition_table.h"
 
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <memory>
+#include <new>
 #include <utility>
 
 #include "config.h"
 #include "evaluation.h"
 
+namespace {
+// Size of the huge pages of x86-64 and ARM64 Linux.
+constexpr size_t huge_page_size{size_t{2} << 20};
+
+// Number of buckets sampled by `get_hashfull`, which samples 1000 entries.
+constexpr size_t hashfull_sample_size{250};
+
+// Packs the information of an entry besides its hash, and the generation of the search that stored it, into a 64-bit
+// word.
+uint64_t pack_data(const PositionInfo& info, uint8_t generation) {
+  return uint64_t{std::bit_cast<uint16_t>(info.best_move)} | uint64_t{std::bit_cast<uint16_t>(info.score)} << 16 |
+         uint64_t{static_cast<uint8_t>(info.node_type)} << 32 | uint64_t{static_cast<uint8_t>(info.depth_left)} << 40 |
+         uint64_t{generation} << 48;
+}
+
+// Unpacks an entry from its hash and its data packed by `pack_data`.
+PositionInfo unpack_data(chess::Board::Hash hash, uint64_t data) {
+  PositionInfo info{};
+  info.hash = hash;
+  info.best_move = std::bit_cast<chess::PackedMove>(static_cast<uint16_t>(data));
+  info.score = std::bit_cast<Evaluation>(static_cast<uint16_t>(data >> 16));
+  info.node_type = static_cast<NodeType>(static_cast<int8_t>(data >> 32));
+  info.depth_left = static_cast<int8_t>(data >> 40);
+  return info;
+}
+
+uint8_t unpack_generation(uint64_t data) { return static_cast<uint8_t>(data >> 48); }
+}  // namespace
+
 PositionInfo::PositionInfo() : hash{chess::Board::Hash::null} {}
 
 PositionInfo::PositionInfo(chess::Board::Hash hash, int depth_left, chess::Move best_move, NodeType node_type,
                            Evaluation score)
     : hash{hash},
-      best_move{best_move},
+      best_move{chess::PackedMove::pack(best_move)},
+      score{score},
       node_type{node_type},
-      depth_left{static_cast<int8_t>(depth_left)},
-      score{score} {}
+      depth_left{static_cast<int8_t>(depth_left)} {}
 
-chess::Move PositionInfo::get_best_move() const { return best_move; }
+chess::Move PositionInfo::get_best_move(const chess::Board& board) const { return best_move.unpack(board); }
 
 std::pair<Evaluation, Evaluation> PositionInfo::get_score_bounds() const {
   switch (node_type) {
@@ -30,18 +66,105 @@ std::pair<Evaluation, Evaluation> PositionInfo::get_score_bounds() const {
   }
 }
 
-TranspositionTable::TranspositionTable() : table(config::transposition_table_size) {}
+TranspositionTable::TranspositionTable(size_t size_mb)
+    : table{nullptr, BucketsDeleter{0}}, bucket_count{0}, generation{0} {
+  resize(size_mb);
+}
+
+void TranspositionTable::resize(size_t size_mb) {
+  const size_t new_bucket_count{std::max<size_t>((size_mb << 20) / sizeof(Bucket), 1)};
+  table = allocate_buckets(new_bucket_count);
+  bucket_count = new_bucket_count;
+  generation = 0;
+}
+
+void TranspositionTable::new_search() { generation++; }
 
-const PositionInfo* TranspositionTable::get(chess::Board::Hash hash) const {
-  const size_t index{hash.to_index(config::transposition_table_size)};
-  if (table[index].hash != hash) return nullptr;  // No matching entry found.
-  return &table[index];
+std::optional<PositionInfo> TranspositionTable::get(chess::Board::Hash hash) const {
+  for (const Entry& entry : table[get_bucket_index(hash)].entries) {
+    const uint64_t data{entry.data.load(std::memory_order::relaxed)};
+    const uint64_t key{entry.key.load(std::memory_order::relaxed)};
+    if ((key ^ data) == hash.hash) return unpack_data(hash, data);
+  }
+  return std::nullopt;  // No matching entry found.
 }
 
 void TranspositionTable::try_update(chess::Board::Hash hash, int depth_left, chess::Move best_move, NodeType node_type,
                                     Evaluation score) {
-  const size_t index{hash.to_index(config::transposition_table_size)};
-  if (table[index].depth_left > depth_left + 1) return;                            // Existing entry is much superior.
-  if (table[index].hash == hash && table[index].depth_left >= depth_left) return;  // Same entry already exists.
-  table[index] = PositionInfo{hash, depth_left, best_move, node_type, score};
+  PositionInfo info{hash, depth_left, best_move, node_type, score};
+  Bucket& bucket{table[get_bucket_index(hash)]};
+  Entry* replaced_entry{nullptr};
+  int replaced_value{std::numeric_limits<int>::max()};
+  for (Entry& entry : bucket.entries) {
+    const uint64_t data{entry.data.load(std::memory_order::relaxed)};
+    const uint64_t key{entry.key.load(std::memory_order::relaxed)};
+    if ((key ^ data) == hash.hash) {
+      const PositionInfo existing{unpack_data(hash, data)};
+      // A deeper entry of the same position already exists. At the same depth, the newer entry is kept, as it was
+      // searched with the latest alpha and beta, which are the most likely to be searched with again.
+      if (unpack_generation(data) == generation && existing.depth_left > depth_left) return;
+      // A node that failed low has no best move, so the hash move of the existing entry is kept for move ordering.
+      if (best_move.is_null()) info.best_move = existing.best_move;
+      replaced_entry = &entry;
+      break;
+    }
+
+    // Empty entries are replaced first, then entries that are older by a search are worth 8 less depth.
+    const bool is_empty{key == 0 && data == 0};
+    const uint8_t age{static_cast<uint8_t>(generation - unpack_generation(data))};
+    const int value{is_empty ? std::numeric_limits<int>::min() : unpack_data(hash, data).depth_left - 8 * age};
+    if (value < replaced_value) {
+      replaced_entry = &entry;
+      replaced_value = value;
+    }
+  }
+
+  const uint64_t data{pack_data(info, generation)};
+  replaced_entry->data.store(data, std::memory_order::relaxed);
+  replaced_entry->key.store(hash.hash ^ data, std::memory_order::relaxed);
+}
+
+int TranspositionTable::get_hashfull() const {
+  const size_t sampled_bucket_count{std::min(bucket_count, hashfull_sample_size)};
+  size_t count{0};
+  for (size_t i{0}; i < sampled_bucket_count; i++) {
+    for (const Entry& entry : table[i].entries) {
+      const uint64_t data{entry.data.load(std::memory_order::relaxed)};
+      const uint64_t key{entry.key.load(std::memory_order::relaxed)};
+      if ((key != 0 || data != 0) && unpack_generation(data) == generation) count++;
+    }
+  }
+  return static_cast<int>(count * 1000 / (sampled_bucket_count * bucket_size));
+}
+
+void TranspositionTable::BucketsDeleter::operator()(Bucket* buckets) const { ::munmap(buckets, mapping_size); }
+
+std::unique_ptr<TranspositionTable::Bucket[], TranspositionTable::BucketsDeleter> TranspositionTable::allocate_buckets(
+    size_t count) {
+  const size_t size{(count * sizeof(Bucket) + huge_page_size - 1) / huge_page_size * huge_page_size};
+  void* mapping{MAP_FAILED};
+#ifdef MAP_HUGETLB
+  // Explicit huge pages are only available if the system reserved some, which it does not by default.
+  mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+  if (mapping == MAP_FAILED) {
+    // Otherwise ask for transparent huge pages, which need the memory to be aligned to a huge page. The mapping is
+    // made larger than needed, so that its unaligned ends can be unmapped.
+    char* const unaligned{static_cast<char*>(
+        ::mmap(nullptr, size + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0))};
+    if (unaligned == MAP_FAILED) throw std::bad_alloc{};
+    const size_t head_size{(huge_page_size - reinterpret_cast<uintptr_t>(unaligned) % huge_page_size) % huge_page_size};
+    if (head_size > 0) ::munmap(unaligned, head_size);
+    ::munmap(unaligned + head_size + size, huge_page_size - head_size);
+#ifdef MADV_HUGEPAGE
+    ::madvise(unaligned + head_size, size, MADV_HUGEPAGE);  // Only a hint, which may be ignored.
+#endif
+    mapping = unaligned + head_size;
+  }
+
+  // Constructing the buckets writes every page of the table, so that the pages are faulted in here (when the table is
+  // allocated or resized) instead of by the first search, which would otherwise spend its time limit zeroing them.
+  Bucket* const buckets{static_cast<Bucket*>(mapping)};
+  std::uninitialized_value_construct_n(buckets, count);
+  return std::unique_ptr<Bucket[], BucketsDeleter>{buckets, BucketsDeleter{size}};
 }
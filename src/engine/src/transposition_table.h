@@ -1,10 +1,16 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <optional>
 #include <utility>
-#include <vector>
 
 #include "chess/board.h"
+#include "chess/packed_move.h"
+#include "config.h"
 #include "evaluation.h"
 
 enum class NodeType : int8_t {
@@ -13,33 +19,103 @@ enum class NodeType : int8_t {
   All   // Nodes with a score below alpha. The stored score is a upperbound.
 };
 
+// The information stored about a position. The best move is packed into 16 bits, so that the information besides the
+// hash fits in a 64-bit word (see TranspositionTable::Entry).
 struct PositionInfo {
   chess::Board::Hash hash;
-  chess::Move best_move;
+  chess::PackedMove best_move;
+  Evaluation score;
   NodeType node_type;
   int8_t depth_left;
-  Evaluation score;
 
   PositionInfo();
   explicit PositionInfo(chess::Board::Hash hash, int depth_left, chess::Move best_move, NodeType node_type,
                         Evaluation score);
 
-  chess::Move get_best_move() const;
+  // Returns the best move, expanded against the given board (which must be the board of this entry).
+  chess::Move get_best_move(const chess::Board& board) const;
 
   std::pair<Evaluation, Evaluation> get_score_bounds() const;
 };
 
+// A transposition table that can be shared by any number of threads without locks: all of its methods except `resize`
+// are safe to call concurrently.
+//
+// Entries are grouped into buckets of one cache line, so that a probe reads a single cache line and each position can
+// be stored in any entry of its bucket. Entries are aged by the search that stored them, so that entries of earlier
+// searches are replaced first even if they were searched deeper. The table is backed by huge pages when the OS allows
+// it, as probes are spread over the whole table and would otherwise almost always miss the TLB.
 class TranspositionTable {
 public:
-  TranspositionTable();
+  explicit TranspositionTable(size_t size_mb = config::default_hash_size_mb);
+
+  // Resizes the table to the given size (in MiB, at least one bucket), which clears it. Throws `std::bad_alloc` if the
+  // new table cannot be allocated, in which case the old table is kept.
+  void resize(size_t size_mb);
+
+  // Starts a new search, so that the entries of previous searches age. Must not be called during a search.
+  void new_search();
 
-  // Returns a pointer to the entry at the given hash, or nullptr if no matching entry was found.
-  const PositionInfo* get(chess::Board::Hash hash) const;
+  // Fetches the bucket of the given hash into the cache, without waiting for it. This should be called as soon as the
+  // hash of a position is known, so that the cache miss of a later `get` overlaps other work.
+  void prefetch(chess::Board::Hash hash) const;
 
-  // Try to update the entry at the given hash. Only succeeds if this new entry is analyzed to a greater depth than the
-  // existing entry.
+  // Returns a copy of the entry at the given hash, or std::nullopt if no matching entry was found.
+  std::optional<PositionInfo> get(chess::Board::Hash hash) const;
+
+  // Try to update the entry at the given hash. If the position has no entry, then the least valuable entry of its
+  // bucket (the oldest and shallowest) is replaced. An entry of the same position is only replaced if this new entry
+  // is analyzed to at least the same depth, or the existing entry is from a previous search. If the new entry has no
+  // best move, then the best move of the replaced entry is kept.
   void try_update(chess::Board::Hash hash, int depth_left, chess::Move best_move, NodeType node_type, Evaluation score);
 
+  // Returns an estimate of the permille of entries that were stored in the current search (the `hashfull` of UCI),
+  // by sampling the first buckets of the table.
+  int get_hashfull() const;
+
 private:
-  std::vector<PositionInfo> table;
-};
\ No newline at end of file
+  // Entries are kept at 16 bytes, as two words that are each read and written atomically (with relaxed ordering, which
+  // compiles to plain loads and stores), but not together. The key is the hash XORed with the data
+  // (https://www.chessprogramming.org/Shared_Hash_Table#Xor), so that if the two words were written by different
+  // threads, or were read while another thread was writing them, the entry almost surely fails to match the hash
+  // instead of returning the data of another position.
+  struct Entry {
+    std::atomic<uint64_t> key;
+    std::atomic<uint64_t> data;
+  };
+  static_assert(sizeof(Entry) == 16);
+  static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+  static constexpr size_t bucket_size{4};
+  struct alignas(64) Bucket {
+    std::array<Entry, bucket_size> entries;
+  };
+  static_assert(sizeof(Bucket) == 64);
+
+  // Unmaps the memory of the buckets, which was mapped by `allocate_buckets`.
+  struct BucketsDeleter {
+    size_t mapping_size;
+    void operator()(Bucket* buckets) const;
+  };
+
+  std::unique_ptr<Bucket[], BucketsDeleter> table;
+  size_t bucket_count;
+  uint8_t generation;  // Incremented for each search, wrapping around.
+
+  // Returns the given number of empty buckets, in memory mapped with huge pages if possible.
+  static std::unique_ptr<Bucket[], BucketsDeleter> allocate_buckets(size_t count);
+
+  // Returns the index of the bucket of the given hash.
+  size_t get_bucket_index(chess::Board::Hash hash) const;
+};
+
+// =============== IMPLEMENTATIONS ===============
+// These are called at every node, so they are inlined.
+
+inline void TranspositionTable::prefetch(chess::Board::Hash hash) const {
+  __builtin_prefetch(&table[get_bucket_index(hash)]);
+}
+
+inline size_t TranspositionTable::get_bucket_index(chess::Board::Hash hash) const {
+  return hash.to_index(bucket_count);
+}
\ No newline at end of file
@@ -11,7 +11,8 @@ SearchConfig::SearchConfig()
       depth{std::nullopt},
       nodes{std::nullopt},
       movetime{std::nullopt},
-      infinite{false} {}
+      infinite{false},
+      threads{1} {}
 
 SearchConfig SearchConfig::from_depth(int32_t new_depth) { return SearchConfig{}.set_depth(new_depth); }
 
@@ -64,4 +65,9 @@ SearchConfig& SearchConfig::set_infinite(bool new_infinite) {
   return *this;
 }
 
+SearchConfig& SearchConfig::set_threads(size_t new_threads) {
+  threads = new_threads;
+  return *this;
+}
+
 }  // namespace engine::uci
\ No newline at end of file
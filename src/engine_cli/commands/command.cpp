@@ -9,6 +9,7 @@
 #include "position_command.h"
 #include "quit_command.h"
 #include "ready_command.h"
+#include "set_option_command.h"
 #include "stop_command.h"
 #include "uci_command.h"
 
@@ -27,6 +28,8 @@ std::expected<std::unique_ptr<Command>, std::string> command::from_string(std::s
     return DebugCommand::from_string(std::move(command_string));
   } else if (first_word == "ucinewgame") {
     return NewGameCommand::from_string(std::move(command_string));
+  } else if (first_word == "setoption") {
+    return SetOptionCommand::from_string(std::move(command_string));
   } else if (first_word == "position") {
     return PositionCommand::from_string(std::move(command_string));
   } else if (first_word == "go") {
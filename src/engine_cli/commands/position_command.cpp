@@ -1,11 +1,14 @@
 #include "position_command.h"
 
+#include <algorithm>
+#include <format>
 #include <iterator>
+#include <optional>
 #include <ranges>
+#include <string_view>
 #include <utility>
 
 #include "../engine_cli.h"
-#include "chess/uci.h"
 #include "command.h"
 #include "parsing.h"
 #include "util/expected.h"
@@ -19,33 +22,42 @@ std::expected<std::unique_ptr<PositionCommand>, std::string> PositionCommand::fr
     return expected::make_unexpected(PositionCommand::get_usage_info());
   }
 
-  //! TODO (low priority): Add input validation for the fen and moves.
-  // Is low priority for now as this cli will only be used by correctly implemented uci programs.
-
   // Setup initial position from startpos / given fen.
-  const chess::Board position{[&input_string, &words]() {
-    if (words[1] == "startpos") return chess::Board::initial();
-
+  std::optional<chess::Board> position{chess::Board::initial()};
+  if (words[1] == "fen") {
     const size_t fen_start{input_string.find("fen") + 3};
-    size_t fen_end{input_string.find_last_of("moves")};
+    size_t fen_end{input_string.find(" moves", fen_start)};
     if (fen_end == std::string::npos) fen_end = input_string.size();
 
-    return chess::Board::from_fen(std::string_view{input_string}.substr(fen_start, fen_end - fen_start));
-  }()};
+    std::string_view fen{std::string_view{input_string}.substr(fen_start, fen_end - fen_start)};
+    fen.remove_prefix(std::min(fen.find_first_not_of(' '), fen.size()));
+    std::string_view error;
+    position = chess::Board::try_from_fen(fen, &error);
+    if (!position) {
+      return expected::make_unexpected(std::format("Invalid fen '{}' of position command: {}", fen, error));
+    }
+  }
 
   // Parse the moves.
   std::vector<chess::Move> moves;
-  chess::Board current_position{position};
+  chess::Board current_position{*position};
   const auto is_not_move_delimiter{[](const auto& word) { return word != "moves"; }};
   for (const auto& uci_move_string : words | std::views::drop_while(is_not_move_delimiter) | std::views::drop(1)) {
-    chess::Move move{chess::uci::move(uci_move_string, current_position)};
-    moves.push_back(move);
-    current_position = current_position.apply_move(move);
+    // Moves are matched against the legal moves, so that invalid and illegal moves are both rejected.
+    chess::MoveContainer legal_moves{current_position.generate_moves()};
+    const auto move{std::ranges::find_if(legal_moves, [&uci_move_string](const chess::Move& legal_move) {
+      return legal_move.to_uci() == uci_move_string;
+    })};
+    if (move == legal_moves.end()) {
+      return expected::make_unexpected(std::format("Illegal move '{}' in position command", uci_move_string));
+    }
+    moves.push_back(*move);
+    current_position = current_position.apply_move(*move);
   }
 
   // Using `new` to access private constructor.
   return expected::make_expected(std::unique_ptr<PositionCommand>{
-      new PositionCommand(std::move(input_string), std::move(position), std::move(moves))});
+      new PositionCommand(std::move(input_string), std::move(*position), std::move(moves))});
 }
 
 std::string_view PositionCommand::get_usage_info() {
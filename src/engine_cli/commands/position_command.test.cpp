@@ -41,6 +41,19 @@ TEST(PositionCommandParsing, ValidFenWithMoves) {
   EXPECT_EQ((*command)->get_position(), expected_board);
 }
 
+TEST(PositionCommandParsing, InvalidFen) {
+  const auto command{PositionCommand::from_string("position fen rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP w KQkq - 0 1")};
+  ASSERT_FALSE(command);
+  EXPECT_TRUE(command.error().starts_with("Invalid fen 'rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP w KQkq - 0 1'"));
+}
+
+TEST(PositionCommandParsing, IllegalMove) {
+  EXPECT_EQ(PositionCommand::from_string("position startpos moves e2e4 e7e4").error(),
+            "Illegal move 'e7e4' in position command");
+  EXPECT_EQ(PositionCommand::from_string("position startpos moves e2").error(),
+            "Illegal move 'e2' in position command");
+}
+
 TEST(PositionCommand, HasCorrectUsageMessage) {
   EXPECT_EQ(PositionCommand::get_usage_info(),
             "Invalid usage of position command. "
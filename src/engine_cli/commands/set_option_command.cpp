@@ -0,0 +1,52 @@
+#include "set_option_command.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "../engine_cli.h"
+#include "command.h"
+#include "parsing.h"
+#include "util/expected.h"
+
+std::expected<std::unique_ptr<SetOptionCommand>, std::string> SetOptionCommand::from_string(
+    std::string input_string) {
+  using expected = util::expected<std::unique_ptr<SetOptionCommand>, std::string>;
+
+  const auto words{command::parsing::split_string(input_string)};
+  if (words.size() < 3 || words[0] != "setoption" || words[1] != "name") {
+    return expected::make_unexpected(SetOptionCommand::get_usage_info());
+  }
+
+  // Both the name and the value may contain spaces, so they are joined back from their words.
+  const auto join{[](auto begin, auto end) {
+    std::string joined;
+    for (auto word{begin}; word != end; word++) {
+      if (!joined.empty()) joined += ' ';
+      joined += *word;
+    }
+    return joined;
+  }};
+  const auto value_word{std::find(words.begin() + 2, words.end(), "value")};
+  std::string name{join(words.begin() + 2, value_word)};
+  std::string value{value_word == words.end() ? std::string{} : join(value_word + 1, words.end())};
+  if (name.empty() || (value_word != words.end() && value.empty())) {
+    return expected::make_unexpected(SetOptionCommand::get_usage_info());
+  }
+
+  // Using `new` to access private constructor.
+  return expected::make_expected(std::unique_ptr<SetOptionCommand>{
+      new SetOptionCommand(std::move(input_string), std::move(name), std::move(value))});
+}
+
+std::string_view SetOptionCommand::get_usage_info() {
+  return "Invalid usage of setoption command. Expected: setoption name <id> [value <x>]";
+}
+
+void SetOptionCommand::execute(EngineCli& engine_cli) const { engine_cli.set_option(name, value); }
+
+const std::string& SetOptionCommand::get_name() const { return name; }
+
+const std::string& SetOptionCommand::get_value() const { return value; }
+
+SetOptionCommand::SetOptionCommand(std::string input_string, std::string name, std::string value)
+    : Command{std::move(input_string)}, name{std::move(name)}, value{std::move(value)} {}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <expected>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "command.h"
+
+class SetOptionCommand : public Command {
+public:
+  // Constructs a SetOptionCommand from an input string, or returns an error string if the input is invalid.
+  [[nodiscard]] static std::expected<std::unique_ptr<SetOptionCommand>, std::string> from_string(
+      std::string input_string);
+
+  [[nodiscard]] static std::string_view get_usage_info();
+
+  virtual void execute(EngineCli& engine_cli) const override;
+
+  [[nodiscard]] const std::string& get_name() const;
+
+  // Returns the value of the option, which is empty if no value was given (e.g. for button options).
+  [[nodiscard]] const std::string& get_value() const;
+
+private:
+  std::string name;
+  std::string value;
+
+  explicit SetOptionCommand(std::string input_string, std::string name, std::string value);
+};
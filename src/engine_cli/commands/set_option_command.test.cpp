@@ -0,0 +1,34 @@
+#include "set_option_command.h"
+
+#include <gtest/gtest.h>
+
+TEST(SetOptionCommandParsing, ValidSetOption) {
+  const auto command{SetOptionCommand::from_string("setoption name Threads value 8")};
+  EXPECT_TRUE(command);
+  EXPECT_EQ((*command)->get_name(), "Threads");
+  EXPECT_EQ((*command)->get_value(), "8");
+}
+
+TEST(SetOptionCommandParsing, ValidSetOptionWithSpaces) {
+  const auto command{SetOptionCommand::from_string("setoption  name Clear Hash")};
+  EXPECT_TRUE(command);
+  EXPECT_EQ((*command)->get_name(), "Clear Hash");
+  EXPECT_EQ((*command)->get_value(), "");
+}
+
+TEST(SetOptionCommandParsing, ErrorsOnMissingName) {
+  const auto command{SetOptionCommand::from_string("setoption value 8")};
+  EXPECT_FALSE(command);
+  EXPECT_EQ(command.error(), SetOptionCommand::get_usage_info());
+}
+
+TEST(SetOptionCommandParsing, ErrorsOnMissingValue) {
+  const auto command{SetOptionCommand::from_string("setoption name Threads value")};
+  EXPECT_FALSE(command);
+  EXPECT_EQ(command.error(), SetOptionCommand::get_usage_info());
+}
+
+TEST(SetOptionCommand, HasCorrectUsageMessage) {
+  EXPECT_EQ(SetOptionCommand::get_usage_info(),
+            "Invalid usage of setoption command. Expected: setoption name <id> [value <x>]");
+}
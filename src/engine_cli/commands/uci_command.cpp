@@ -4,12 +4,15 @@
 
 #include "../engine_cli.h"
 #include "../outputs/id_output.h"
+#include "../outputs/spin_option_output.h"
 #include "../outputs/uciok_output.h"
 #include "command.h"
 
 void UciCommand::execute(EngineCli &engine_cli) const {
   IdOutput engine_info{std::string{engine_cli.get_name()}, std::string{engine_cli.get_author()}};
   engine_cli.write(engine_info);
+  engine_cli.write(SpinOptionOutput{"Threads", 1, 1, EngineCli::max_thread_count});
+  engine_cli.write(SpinOptionOutput{"Hash", EngineCli::default_hash_size, 1, EngineCli::max_hash_size});
   engine_cli.write(UciOkOutput{});
 }
 
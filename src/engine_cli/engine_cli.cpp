@@ -1,8 +1,11 @@
 #include "engine_cli.h"
 
+#include <format>
 #include <functional>
+#include <new>
 
 #include "chess_engine/engine.h"
+#include "commands/parsing.h"
 #include "outputs/best_move_output.h"
 #include "outputs/error_output.h"
 
@@ -12,7 +15,8 @@ EngineCli::EngineCli(std::istream& input_stream, std::ostream& output_stream)
       position{chess::Board::initial()},
       moves{},
       debug_mode{false},
-      done{false} {}
+      done{false},
+      thread_count{1} {}
 
 void EngineCli::start() {
   while (!done) {
@@ -43,6 +47,32 @@ void EngineCli::new_game() { ongoing_search.reset(); }
 
 void EngineCli::set_debug(bool new_debug_mode) { debug_mode = new_debug_mode; }
 
+void EngineCli::set_option(std::string_view name, std::string_view value) {
+  if (name == "Threads") {
+    const auto new_thread_count{command::parsing::parse_integer<int64_t>(value)};
+    if (!new_thread_count || *new_thread_count < 1 || *new_thread_count > max_thread_count) {
+      write(ErrorOutput{std::format("Invalid value '{}' for option 'Threads'. Expected: an integer from 1 to {}", value,
+                                    max_thread_count)});
+      return;
+    }
+    thread_count = static_cast<size_t>(*new_thread_count);
+  } else if (name == "Hash") {
+    const auto new_hash_size{command::parsing::parse_integer<int64_t>(value)};
+    if (!new_hash_size || *new_hash_size < 1 || *new_hash_size > max_hash_size) {
+      write(ErrorOutput{std::format("Invalid value '{}' for option 'Hash'. Expected: an integer from 1 to {}", value,
+                                    max_hash_size)});
+      return;
+    }
+    try {
+      ongoing_search.set_hash_size(static_cast<size_t>(*new_hash_size));
+    } catch (const std::bad_alloc&) {
+      write(ErrorOutput{std::format("Could not allocate {} MiB for option 'Hash'. The previous size is kept", value)});
+    }
+  } else {
+    write(ErrorOutput{std::format("Unrecognized option '{}'", name)});
+  }
+}
+
 void EngineCli::set_position(chess::Board new_position, std::vector<chess::Move> new_moves) {
   position = std::move(new_position);
   moves = std::move(new_moves);
@@ -54,6 +84,7 @@ void EngineCli::write(const Output& output) {
 }
 
 void EngineCli::go(engine::uci::SearchConfig config) {
+  config.set_threads(thread_count);
   const bool started{ongoing_search.go(position, moves, std::move(config), *this)};
   if (!started) {
     //! TODO (low priority): This write could occur too late, for example if the go command
@@ -99,6 +130,11 @@ void EngineCli::OngoingSearch::reset() {
   engine.reset();
 }
 
+void EngineCli::OngoingSearch::set_hash_size(size_t size_mb) {
+  wait();
+  engine.set_hash_size(size_mb);
+}
+
 EngineCli::OngoingSearch::~OngoingSearch() {
   if (thread.joinable()) thread.join();
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <istream>
 #include <memory>
 #include <mutex>
@@ -17,6 +18,12 @@
 
 class EngineCli {
 public:
+  // Maximum value of the Threads option.
+  static constexpr int64_t max_thread_count{1024};
+  // Default and maximum values of the Hash option (the size of the transposition table in MiB).
+  static constexpr int64_t default_hash_size{64};
+  static constexpr int64_t max_hash_size{int64_t{1} << 16};
+
   explicit EngineCli(std::istream& input_stream, std::ostream& output_stream);
 
   void start();
@@ -31,6 +38,9 @@ public:
   // Set the debug mode.
   void set_debug(bool new_debug_mode);
 
+  // Sets the option (declared in response to the uci command) with the given name to the given value.
+  void set_option(std::string_view name, std::string_view value);
+
   // Update the position.
   void set_position(chess::Board new_position, std::vector<chess::Move> new_moves);
 
@@ -56,6 +66,7 @@ private:
   std::vector<chess::Move> moves;
   bool debug_mode;
   bool done;
+  size_t thread_count;  // Number of threads that searches use.
 
   // A threadsafe class to manage the ongoing search.
   class OngoingSearch {
@@ -76,6 +87,9 @@ private:
     // Resets the engine state.
     void reset();
 
+    // Resizes the transposition table of the engine (in MiB), once the current search (if any) is done.
+    void set_hash_size(size_t size_mb);
+
     ~OngoingSearch();
 
   private:
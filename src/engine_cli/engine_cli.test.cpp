@@ -19,6 +19,10 @@ TEST(EngineCli, RespondsToUciCommand) {
   std::getline(output_stream, s);
   EXPECT_EQ(s, "id author placeholderAuthor");
   std::getline(output_stream, s);
+  EXPECT_EQ(s, "option name Threads type spin default 1 min 1 max 1024");
+  std::getline(output_stream, s);
+  EXPECT_EQ(s, "option name Hash type spin default 64 min 1 max 65536");
+  std::getline(output_stream, s);
   EXPECT_EQ(s, "uciok");
 }
 
@@ -0,0 +1,10 @@
+#include "spin_option_output.h"
+
+#include <format>
+
+SpinOptionOutput::SpinOptionOutput(std::string name, int64_t default_value, int64_t min_value, int64_t max_value)
+    : Output{}, name{std::move(name)}, default_value{default_value}, min_value{min_value}, max_value{max_value} {}
+
+std::string SpinOptionOutput::to_string() const {
+  return std::format("option name {} type spin default {} min {} max {}", name, default_value, min_value, max_value);
+}
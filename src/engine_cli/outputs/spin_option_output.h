@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "output.h"
+
+// Declares an option of the engine that takes an integer in a range, in response to the uci command.
+class SpinOptionOutput : public Output {
+public:
+  explicit SpinOptionOutput(std::string name, int64_t default_value, int64_t min_value, int64_t max_value);
+
+  [[nodiscard]] virtual std::string to_string() const override;
+
+private:
+  std::string name;
+  int64_t default_value;
+  int64_t min_value;
+  int64_t max_value;
+};
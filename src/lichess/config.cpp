@@ -20,6 +20,10 @@ bool Config::should_issue_challenges() const { return issue_challenges; }
 
 std::chrono::minutes Config::get_challenge_interval() const { return challenge_interval; }
 
+std::optional<std::filesystem::path> Config::get_opening_book_path() const { return opening_book_path; }
+
+size_t Config::get_threads() const { return threads; }
+
 namespace {
 
 // Parses a line in the configuration stream. Returns pair<key, value>.
@@ -45,6 +49,8 @@ Config Config::from_stream(std::istream& config_stream) {
   auto challenge_interval = std::optional<std::chrono::minutes>{};
   auto log_path = std::optional<std::filesystem::path>{};
   auto log_level = std::optional<Logger::Level>{};
+  auto opening_book_path = std::optional<std::filesystem::path>{};
+  auto threads = std::optional<size_t>{};
 
   auto line = std::string{};
   while (std::getline(config_stream, line)) {
@@ -65,6 +71,12 @@ Config Config::from_stream(std::istream& config_stream) {
       log_level = Logger::parse_level(value);
     } else if (key == "LOG_PATH") {
       log_path = std::filesystem::path{value};
+    } else if (key == "OPENING_BOOK_PATH") {
+      opening_book_path = std::filesystem::path{value};
+    } else if (key == "THREADS") {
+      const int thread_count = std::stoi(std::string{value});
+      if (thread_count < 1) throw std::runtime_error{"Invalid configuration for THREADS: Must be at least 1."};
+      threads = static_cast<size_t>(thread_count);
     } else {
       const auto error_message = std::format("Unknown key in configuration file: {}", line);
       throw std::runtime_error{error_message};
@@ -78,7 +90,7 @@ Config Config::from_stream(std::istream& config_stream) {
   if (!issue_challenges) missing_keys.push_back("ISSUE_CHALLENGES");
   if (issue_challenges.value() && !challenge_interval) missing_keys.push_back("CHALLENGE_INTERVAL_MINUTES");
   if (!log_level) missing_keys.push_back("LOG_LEVEL");
-  // log_path is optional.
+  // log_path, opening_book_path and threads are optional.
   if (!missing_keys.empty()) {
     auto missing_keys_string = std::string{};
     missing_keys_string += missing_keys[0];
@@ -92,15 +104,18 @@ Config Config::from_stream(std::istream& config_stream) {
 
   return Config{*std::move(lichess_token),    *std::move(lichess_bot_name),
                 *std::move(issue_challenges), challenge_interval.value_or(std::chrono::minutes{0}),
-                std::move(log_path),          *std::move(log_level)};
+                std::move(log_path),          *std::move(log_level),
+                std::move(opening_book_path), threads.value_or(1)};
 }
 
 Config::Config(std::string lichess_token, std::string lichess_bot_name, bool issue_challenges,
                std::chrono::minutes challenge_interval, std::optional<std::filesystem::path> log_path,
-               Logger::Level log_level)
+               Logger::Level log_level, std::optional<std::filesystem::path> opening_book_path, size_t threads)
     : lichess_token{std::move(lichess_token)},
       lichess_bot_name{std::move(lichess_bot_name)},
       issue_challenges{issue_challenges},
       challenge_interval{challenge_interval},
       log_path{std::move(log_path)},
-      log_level{log_level} {}
\ No newline at end of file
+      log_level{log_level},
+      opening_book_path{std::move(opening_book_path)},
+      threads{threads} {}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
 #include <filesystem>
 #include <optional>
 #include <string>
@@ -23,6 +24,10 @@ public:
 
   std::chrono::minutes get_challenge_interval() const;
 
+  std::optional<std::filesystem::path> get_opening_book_path() const;
+
+  size_t get_threads() const;
+
 private:
   std::string lichess_token;                // API token with Bot permissions enabled.
   std::string lichess_bot_name;             // Username of the lichess bot.
@@ -31,8 +36,11 @@ private:
                                             // idling for this interval.
   std::optional<std::filesystem::path> log_path;  // Path to write logs to. Should write to stdout if not provided.
   Logger::Level log_level;                        // What types of messages should be logged.
+  // Path to an opening book to play moves from. No book is used if not provided.
+  std::optional<std::filesystem::path> opening_book_path;
+  size_t threads;  // Number of threads to search with. Defaults to 1 if not provided.
 
   explicit Config(std::string lichess_token, std::string lichess_bot_name, bool issue_challenges,
                   std::chrono::minutes challenge_interval, std::optional<std::filesystem::path> log_path,
-                  Logger::Level log_level);
+                  Logger::Level log_level, std::optional<std::filesystem::path> opening_book_path, size_t threads);
 };
\ No newline at end of file
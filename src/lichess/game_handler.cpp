@@ -1,6 +1,7 @@
 #include "game_handler.h"
 
 #include <algorithm>
+#include <optional>
 
 #include "chess/uci.h"
 #include "chess_engine/uci.h"
@@ -18,7 +19,9 @@ GameHandler::GameHandler(const Config& config, const Lichess& lichess, const std
       binc{},
       ply_count{0},
       board{chess::Board::initial()},
-      engine{} {}
+      engine{} {
+  if (const auto opening_book_path{config.get_opening_book_path()}) engine.load_opening_book(*opening_book_path);
+}
 
 void GameHandler::listen() {
   Logger::get().format_info("Handling game {}", game_id);
@@ -31,6 +34,7 @@ std::pair<chess::Move, engine::Search::DebugInfo> GameHandler::choose_move() {
   search_config.set_winc(winc);
   search_config.set_btime(btime);
   search_config.set_binc(binc);
+  search_config.set_threads(config.get_threads());
 
   //! TODO: Find a better way to account for network latency.
   std::chrono::milliseconds latency_compensation{500};
@@ -75,16 +79,24 @@ bool GameHandler::handle_game_update(const json& state) {
 
   if (board.is_white_to_move() != is_white) return true;  // Not my turn.
 
+  // Book moves are played without searching, so that no time is spent on them.
+  if (const std::optional<chess::Move> book_move{engine.get_book_move()}) {
+    lichess.send_move(game_id, book_move->to_uci());
+    Logger::get().format_info("Found book move {} for game {}", book_move->to_algebraic(), game_id);
+    return true;
+  }
+
   const auto [move, debug] = choose_move();
   lichess.send_move(game_id, move.to_uci());
 
   Logger::get().format_info(
-      "Found move {} for game {} in {}ms (depth {} reached, {}k nodes, {}k quiescent nodes, {}/{}k TT, {}/{}k NM, "
-      "{}/{}k QDP, {} eval)",
+      "Found move {} for game {} in {}ms (depth {} reached, {}k nodes, {}k quiescent nodes, {}/{}k TT, {}/1000 "
+      "hashfull, {}/{}k NM, {}/{}k QDP, {} eval)",
       move.to_algebraic(), game_id, debug.time_spent.count(), debug.search_depth, debug.normal_node_count / 1000,
       debug.quiescence_node_count / 1000, debug.transposition_table_success / 1000,
-      debug.transposition_table_total / 1000, debug.null_move_success / 1000, debug.null_move_total / 1000,
-      debug.q_delta_pruning_success / 1000, debug.q_delta_pruning_total / 1000, debug.evaluation);
+      debug.transposition_table_total / 1000, debug.hashfull, debug.null_move_success / 1000,
+      debug.null_move_total / 1000, debug.q_delta_pruning_success / 1000, debug.q_delta_pruning_total / 1000,
+      debug.evaluation);
   return true;
 }
 
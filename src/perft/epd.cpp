@@ -0,0 +1,27 @@
+#include "epd.h"
+
+#include <sstream>
+
+std::vector<EpdEntry> read_epd(std::istream& input) {
+  std::vector<EpdEntry> entries;
+  std::string line;
+  while (std::getline(input, line)) {
+    if (line.empty() || line[0] == '#') continue;
+
+    std::istringstream line_stream{line};
+    EpdEntry entry;
+    std::getline(line_stream, entry.fen, ';');
+    entry.fen.erase(entry.fen.find_last_not_of(" \t\r") + 1);
+
+    std::string field;
+    while (std::getline(line_stream, field, ';')) {
+      std::istringstream field_stream{field};
+      std::string depth;
+      uint64_t nodes;
+      if (!(field_stream >> depth >> nodes) || depth.size() < 2 || depth[0] != 'D') continue;
+      entry.expected_nodes.emplace_back(std::stoi(depth.substr(1)), nodes);
+    }
+    entries.push_back(std::move(entry));
+  }
+  return entries;
+}
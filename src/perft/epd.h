@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// A position from an EPD perft suite, in the common format `<fen> ;D1 <nodes> ;D2 <nodes> ...`.
+struct EpdEntry {
+  std::string fen;
+  std::vector<std::pair<int, uint64_t>> expected_nodes;  // {depth, expected node count}.
+};
+
+// Reads all positions from an EPD perft suite. Empty lines and lines starting with '#' are skipped.
+std::vector<EpdEntry> read_epd(std::istream& input);
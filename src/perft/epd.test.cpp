@@ -0,0 +1,22 @@
+#include "epd.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+TEST(ReadEpd, ParsesFenAndExpectedNodes) {
+  std::istringstream input{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - ;D1 20 ;D2 400\n"};
+  const auto entries{read_epd(input)};
+  ASSERT_EQ(entries.size(), 1);
+  EXPECT_EQ(entries[0].fen, "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -");
+  ASSERT_EQ(entries[0].expected_nodes.size(), 2);
+  EXPECT_EQ(entries[0].expected_nodes[0], std::make_pair(1, uint64_t{20}));
+  EXPECT_EQ(entries[0].expected_nodes[1], std::make_pair(2, uint64_t{400}));
+}
+
+TEST(ReadEpd, SkipsCommentsAndEmptyLines) {
+  std::istringstream input{"# comment\n\n8/8/8/8/8/8/8/K6k w - - ;D1 3\n"};
+  const auto entries{read_epd(input)};
+  ASSERT_EQ(entries.size(), 1);
+  EXPECT_EQ(entries[0].fen, "8/8/8/8/8/8/8/K6k w - -");
+}
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "chess/board.h"
+#include "epd.h"
+#include "perft.h"
+
+namespace {
+
+constexpr std::string_view usage{
+    "Usage:\n"
+    "  chess_perft [options] <depth> [fen]        Count the nodes of a position (default: initial position).\n"
+    "  chess_perft [options] --epd <file>         Validate the node counts of every position in an EPD suite.\n"
+    "\n"
+    "Options:\n"
+    "  --threads <n>      Number of threads (default: number of hardware threads).\n"
+    "  --hash <mb>        Size of the perft hash table in megabytes, or 0 to disable it (default: 64).\n"
+    "  --divide           Print the node count under each root move.\n"
+    "  --max-depth <n>    Only validate depths up to n in an EPD suite.\n"};
+
+struct Options {
+  size_t thread_count{std::max(std::thread::hardware_concurrency(), 1u)};
+  size_t hash_megabytes{64};
+  bool divide{false};
+  int max_depth{100};
+  std::optional<std::string> epd_path;
+  int depth{0};
+  std::string fen{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"};
+};
+
+std::optional<Options> parse_options(int argc, char* argv[]) {
+  Options options;
+  std::optional<int> depth;
+  std::string fen;
+  for (int i{1}; i < argc; i++) {
+    const std::string_view arg{argv[i]};
+    const bool has_value{i + 1 < argc};
+    if (arg == "--threads" && has_value) options.thread_count = std::stoul(argv[++i]);
+    else if (arg == "--hash" && has_value) options.hash_megabytes = std::stoul(argv[++i]);
+    else if (arg == "--max-depth" && has_value) options.max_depth = std::stoi(argv[++i]);
+    else if (arg == "--epd" && has_value) options.epd_path = argv[++i];
+    else if (arg == "--divide") options.divide = true;
+    else if (arg.starts_with("--")) return std::nullopt;
+    else if (!depth) depth = std::stoi(std::string{arg});
+    else {
+      if (!fen.empty()) fen += ' ';
+      fen += arg;
+    }
+  }
+  if (options.epd_path) return options;
+  if (!depth || *depth < 0) return std::nullopt;
+  options.depth = *depth;
+  if (!fen.empty()) options.fen = fen;
+  return options;
+}
+
+double to_seconds(std::chrono::steady_clock::duration duration) {
+  return std::chrono::duration<double>(duration).count();
+}
+
+void print_speed(uint64_t nodes, std::chrono::steady_clock::duration duration) {
+  const double seconds{to_seconds(duration)};
+  std::cout << "Nodes: " << nodes << "\nTime: " << seconds << " s\nNodes/sec: "
+            << static_cast<uint64_t>(nodes / seconds) << std::endl;
+}
+
+int run_position(const Options& options) {
+  Perft perft{options.thread_count, options.hash_megabytes};
+  const chess::Board board{chess::Board::from_fen(options.fen)};
+  const auto start_time{std::chrono::steady_clock::now()};
+  uint64_t nodes{0};
+  if (options.divide && options.depth > 0) {
+    for (const auto& [move, move_nodes] : perft.divide(board, options.depth)) {
+      std::cout << move.to_uci() << ": " << move_nodes << "\n";
+      nodes += move_nodes;
+    }
+    std::cout << "\n";
+  } else {
+    nodes = perft.count(board, options.depth);
+  }
+  print_speed(nodes, std::chrono::steady_clock::now() - start_time);
+  return EXIT_SUCCESS;
+}
+
+int run_epd(const Options& options) {
+  std::ifstream file{*options.epd_path};
+  if (!file) {
+    std::cerr << "Could not open " << *options.epd_path << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  Perft perft{options.thread_count, options.hash_megabytes};
+  size_t failures{0};
+  uint64_t total_nodes{0};
+  const auto start_time{std::chrono::steady_clock::now()};
+  for (const auto& entry : read_epd(file)) {
+    const chess::Board board{chess::Board::from_fen(entry.fen)};
+    for (const auto& [depth, expected_nodes] : entry.expected_nodes) {
+      if (depth > options.max_depth) continue;
+      const uint64_t nodes{perft.count(board, depth)};
+      total_nodes += nodes;
+      if (nodes != expected_nodes) failures++;
+      std::cout << (nodes == expected_nodes ? "PASS " : "FAIL ") << entry.fen << " depth " << depth << ": " << nodes
+                << " (expected " << expected_nodes << ")" << std::endl;
+    }
+  }
+  std::cout << "\n" << failures << " failure(s)\n";
+  print_speed(total_nodes, std::chrono::steady_clock::now() - start_time);
+  return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const auto options{parse_options(argc, argv)};
+  if (!options) {
+    std::cerr << usage;
+    return EXIT_FAILURE;
+  }
+  return options->epd_path ? run_epd(*options) : run_position(*options);
+}
@@ -0,0 +1,62 @@
+#include "perft.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+Perft::Perft(size_t thread_count, size_t hash_megabytes)
+    : thread_count{std::max<size_t>(thread_count, 1)}, hash{hash_megabytes} {}
+
+uint64_t Perft::count(const chess::Board& board, int depth) {
+  if (depth == 0) return 1;
+  uint64_t nodes{0};
+  for (const auto& [move, move_nodes] : divide(board, depth)) nodes += move_nodes;
+  return nodes;
+}
+
+std::vector<std::pair<chess::Move, uint64_t>> Perft::divide(const chess::Board& board, int depth) {
+  chess::MoveContainer moves{board.generate_moves()};
+  std::vector<std::pair<chess::Move, uint64_t>> result;
+  for (const auto& move : moves) result.emplace_back(move, 1);
+  if (depth <= 1) return result;
+
+  // The tree is split into tasks at the second ply rather than the root, as there are few root moves, and their
+  // subtrees differ widely in size. Idle threads take the next unclaimed task.
+  struct Task {
+    size_t root_index;
+    chess::Board board;
+  };
+  std::vector<Task> tasks;
+  for (size_t i{0}; i < moves.size(); i++) {
+    const chess::Board root_board{board.apply_move(moves[i])};
+    for (const auto& move : root_board.generate_moves()) tasks.push_back(Task{i, root_board.apply_move(move)});
+  }
+
+  std::vector<std::atomic<uint64_t>> root_nodes(moves.size());
+  std::atomic<size_t> next_task{0};
+  const auto work = [&]() {
+    for (size_t i{next_task++}; i < tasks.size(); i = next_task++) {
+      root_nodes[tasks[i].root_index] += search(tasks[i].board, depth - 2);
+    }
+  };
+  {
+    std::vector<std::jthread> threads;
+    for (size_t i{1}; i < thread_count; i++) threads.emplace_back(work);
+    work();
+  }
+
+  for (size_t i{0}; i < moves.size(); i++) result[i].second = root_nodes[i];
+  return result;
+}
+
+uint64_t Perft::search(const chess::Board& board, int depth) {
+  if (depth == 0) return 1;
+  if (depth == 1) return board.count_moves();  // Bulk counting.
+
+  if (const auto nodes{hash.get(board.get_hash(), depth)}) return *nodes;
+  uint64_t nodes{0};
+  chess::MoveContainer moves{board.generate_moves()};
+  for (const auto& move : moves) nodes += search(board.apply_move(move), depth - 1);
+  hash.put(board.get_hash(), depth, nodes);
+  return nodes;
+}
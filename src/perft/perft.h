@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "chess/board.h"
+#include "chess/move.h"
+#include "perft_hash.h"
+
+// Counts the leaf nodes of the legal move tree (https://www.chessprogramming.org/Perft), using multiple threads and a
+// shared hash table of subtree counts.
+class Perft {
+public:
+  explicit Perft(size_t thread_count, size_t hash_megabytes);
+
+  // Returns the number of leaf nodes of the tree of the given depth.
+  uint64_t count(const chess::Board& board, int depth);
+
+  // Returns the number of leaf nodes under each root move, for a tree of the given depth (which must be at least 1).
+  std::vector<std::pair<chess::Move, uint64_t>> divide(const chess::Board& board, int depth);
+
+private:
+  size_t thread_count;
+  PerftHash hash;
+
+  // Single-threaded count of the leaf nodes of the tree of the given depth.
+  uint64_t search(const chess::Board& board, int depth);
+};
@@ -0,0 +1,42 @@
+#include "perft.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "chess/board.h"
+
+// Node counts are taken from https://www.chessprogramming.org/Perft_Results
+
+TEST(Perft, InitialPosition) {
+  Perft perft{4, 16};
+  EXPECT_EQ(perft.count(chess::Board::initial(), 0), 1);
+  EXPECT_EQ(perft.count(chess::Board::initial(), 1), 20);
+  EXPECT_EQ(perft.count(chess::Board::initial(), 5), 4865609);
+}
+
+TEST(Perft, Position2) {
+  const chess::Board board{
+      chess::Board::from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 0")};
+  Perft perft{4, 16};
+  EXPECT_EQ(perft.count(board, 4), 4085603);
+  // Repeated searches hit the hash table.
+  EXPECT_EQ(perft.count(board, 4), 4085603);
+}
+
+TEST(Perft, WithoutHash) {
+  const chess::Board board{chess::Board::from_fen("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 0")};
+  Perft perft{1, 0};
+  EXPECT_EQ(perft.count(board, 5), 674624);
+}
+
+TEST(Perft, DivideSumsToCount) {
+  const chess::Board board{
+      chess::Board::from_fen("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 0")};
+  Perft perft{2, 16};
+  const auto divide{perft.divide(board, 3)};
+  EXPECT_EQ(divide.size(), 6);
+  uint64_t nodes{0};
+  for (const auto& [move, move_nodes] : divide) nodes += move_nodes;
+  EXPECT_EQ(nodes, 9467);
+}
@@ -0,0 +1,20 @@
+#include "perft_hash.h"
+
+PerftHash::PerftHash(size_t megabytes) : table(megabytes * 1024 * 1024 / sizeof(Entry)) {}
+
+std::optional<uint64_t> PerftHash::get(chess::Board::Hash hash, int depth) const {
+  if (table.empty()) return std::nullopt;
+  const Entry& entry{table[hash.to_index(table.size())]};
+  const uint64_t data{entry.data.load(std::memory_order_relaxed)};
+  const uint64_t checked_hash{entry.checked_hash.load(std::memory_order_relaxed)};
+  if ((checked_hash ^ data) != hash.hash || (data & 0xff) != static_cast<uint64_t>(depth)) return std::nullopt;
+  return data >> 8;
+}
+
+void PerftHash::put(chess::Board::Hash hash, int depth, uint64_t nodes) {
+  if (table.empty()) return;
+  Entry& entry{table[hash.to_index(table.size())]};
+  const uint64_t data{nodes << 8 | static_cast<uint64_t>(depth)};
+  entry.checked_hash.store(hash.hash ^ data, std::memory_order_relaxed);
+  entry.data.store(data, std::memory_order_relaxed);
+}
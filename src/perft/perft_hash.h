@@ -0,0 +1,30 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "chess/board.h"
+
+// A hash table of perft subtree node counts, which is shared (without locks) between threads.
+// Each entry stores `hash ^ data` alongside `data`. An entry torn by concurrent writes then fails the hash check on
+// lookup, instead of returning a wrong count (https://www.chessprogramming.org/Shared_Hash_Table#Lockless).
+class PerftHash {
+public:
+  // Creates a table that uses at most `megabytes` of memory. A size of 0 disables the table.
+  explicit PerftHash(size_t megabytes);
+
+  // Returns the node count of the given position searched to the given depth, if it is stored.
+  std::optional<uint64_t> get(chess::Board::Hash hash, int depth) const;
+
+  // Stores the node count of the given position searched to the given depth, replacing any existing entry.
+  void put(chess::Board::Hash hash, int depth, uint64_t nodes);
+
+private:
+  struct Entry {
+    std::atomic<uint64_t> checked_hash;  // `hash ^ data`.
+    std::atomic<uint64_t> data;          // Node count in the upper 56 bits, depth in the lower 8 bits.
+  };
+  std::vector<Entry> table;
+};
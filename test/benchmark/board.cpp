@@ -2,6 +2,9 @@
 
 #include <benchmark/benchmark.h>
 
+#include "chess/move_gen.h"
+#include "chess/packed_board.h"
+
 using namespace chess;
 
 static void board_initial_position_move_generation(benchmark::State& state) {
@@ -67,6 +70,33 @@ static void board_quiescence_move_and_checks_generation(benchmark::State& state)
 }
 BENCHMARK(board_quiescence_move_and_checks_generation);
 
+static void board_middlegame_pseudo_legal_move_generation(benchmark::State& state) {
+  Board board = Board::from_fen("r2q1rk1/2p2ppp/p7/1pbQp3/3n4/PB1P3P/1PP2PP1/RNB1R1K1 b - - 0 0");
+  for (auto _ : state) {
+    MoveContainer moves = move_gen::generate_pseudo_legal_moves(board);
+    benchmark::DoNotOptimize(moves);
+  }
+}
+BENCHMARK(board_middlegame_pseudo_legal_move_generation);
+
+static void board_quiescence_pseudo_legal_move_generation(benchmark::State& state) {
+  Board board = Board::from_fen("r1b1k2r/2p2pb1/5n2/1qnpp2B/RP1PP1Q1/P6N/5Ppp/4K3 w kq - 0 0");
+  for (auto _ : state) {
+    MoveContainer moves = move_gen::generate_pseudo_legal_quiescence_moves(board);
+    benchmark::DoNotOptimize(moves);
+  }
+}
+BENCHMARK(board_quiescence_pseudo_legal_move_generation);
+
+static void board_middlegame_move_counting(benchmark::State& state) {
+  Board board = Board::from_fen("r2q1rk1/2p2ppp/p7/1pbQp3/3n4/PB1P3P/1PP2PP1/RNB1R1K1 b - - 0 0");
+  for (auto _ : state) {
+    size_t move_count = board.count_moves();
+    benchmark::DoNotOptimize(move_count);
+  }
+}
+BENCHMARK(board_middlegame_move_counting);
+
 static void board_has_moves(benchmark::State& state) {
   Board board = Board::from_fen("r1b1k2r/2p2pb1/3K1n2/1qnpp2B/RP1PP1Q1/P6N/5Ppp/8 b kq - 0 1 0 0");
   for (auto _ : state) {
@@ -74,4 +104,68 @@ static void board_has_moves(benchmark::State& state) {
     benchmark::DoNotOptimize(has_moves);
   }
 }
-BENCHMARK(board_has_moves);
\ No newline at end of file
+BENCHMARK(board_has_moves);
+
+static void board_see(benchmark::State& state) {
+  Board board = Board::from_fen("1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 0");
+  const Move move = Move::move(Bitboard::D3, Bitboard::E5, PieceType::Knight, PieceType::Pawn);
+  for (auto _ : state) {
+    int32_t see = board.see(move);
+    benchmark::DoNotOptimize(see);
+  }
+}
+BENCHMARK(board_see);
+
+static void board_get_hash(benchmark::State& state) {
+  Board board = Board::from_fen("r2q1rk1/2p2ppp/p7/1pbQp3/3n4/PB1P3P/1PP2PP1/RNB1R1K1 b - - 0 0");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(board);
+    Board::Hash hash = board.get_hash();
+    benchmark::DoNotOptimize(hash);
+  }
+}
+BENCHMARK(board_get_hash);
+
+// Cost of hashing a board from scratch, which is what every node paid before the hash was maintained incrementally.
+static void board_compute_hash(benchmark::State& state) {
+  Board board = Board::from_fen("r2q1rk1/2p2ppp/p7/1pbQp3/3n4/PB1P3P/1PP2PP1/RNB1R1K1 b - - 0 0");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(board);
+    Board::Hash hash = board.compute_hash();
+    benchmark::DoNotOptimize(hash);
+  }
+}
+BENCHMARK(board_compute_hash);
+
+// Hash cost per node: applies every legal move and hashes each resulting board.
+static void board_apply_move_and_get_hash(benchmark::State& state) {
+  Board board = Board::from_fen("r2q1rk1/2p2ppp/p7/1pbQp3/3n4/PB1P3P/1PP2PP1/RNB1R1K1 b - - 0 0");
+  MoveContainer moves = board.generate_moves();
+  for (auto _ : state) {
+    for (const Move& move : moves) {
+      Board::Hash hash = board.apply_move(move).get_hash();
+      benchmark::DoNotOptimize(hash);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * moves.size());
+}
+BENCHMARK(board_apply_move_and_get_hash);
+
+static void board_from_fen(benchmark::State& state) {
+  for (auto _ : state) {
+    Board board = Board::from_fen("r2q1rk1/2p2ppp/p7/1pbQp3/3n4/PB1P3P/1PP2PP1/RNB1R1K1 b - - 0 0");
+    benchmark::DoNotOptimize(board);
+  }
+}
+BENCHMARK(board_from_fen);
+
+static void board_unpack(benchmark::State& state) {
+  PackedBoard packed =
+      PackedBoard::pack(Board::from_fen("r2q1rk1/2p2ppp/p7/1pbQp3/3n4/PB1P3P/1PP2PP1/RNB1R1K1 b - - 0 0"));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(packed);
+    Board board = packed.unpack();
+    benchmark::DoNotOptimize(board);
+  }
+}
+BENCHMARK(board_unpack);
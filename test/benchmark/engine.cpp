@@ -2,6 +2,7 @@
 
 #include <benchmark/benchmark.h>
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -14,19 +15,46 @@ using namespace chess;
 static void engine_initial_position_search(benchmark::State& state) {
   Board board = Board::initial();
   Engine engine{board};
+  int64_t node_count{0};
   for (auto _ : state) {
     auto move_info = engine.search_sync(engine::uci::SearchConfig::from_depth(13));
+    node_count += move_info.second.normal_node_count + move_info.second.quiescence_node_count;
     benchmark::DoNotOptimize(move_info);
   }
+  state.counters["nodes"] = benchmark::Counter(node_count, benchmark::Counter::kAvgIterations);
+  state.counters["nodes_per_second"] = benchmark::Counter(node_count, benchmark::Counter::kIsRate);
 }
-BENCHMARK(engine_initial_position_search);
+BENCHMARK(engine_initial_position_search)->UseRealTime();
 
 static void engine_position_1_search(benchmark::State& state) {
   Board board = Board::from_fen("2r2r2/1Q2k1p1/p2p2q1/7p/P3Np2/7P/6P1/5R1K b - - 0 0");
   Engine engine{board};
+  int64_t node_count{0};
   for (auto _ : state) {
     auto move_info = engine.search_sync(engine::uci::SearchConfig::from_depth(13));
+    node_count += move_info.second.normal_node_count + move_info.second.quiescence_node_count;
     benchmark::DoNotOptimize(move_info);
   }
+  state.counters["nodes"] = benchmark::Counter(node_count, benchmark::Counter::kAvgIterations);
+  state.counters["nodes_per_second"] = benchmark::Counter(node_count, benchmark::Counter::kIsRate);
 }
-BENCHMARK(engine_position_1_search);
\ No newline at end of file
+BENCHMARK(engine_position_1_search)->UseRealTime();
+
+// Time to reach a fixed depth with Lazy SMP, by number of threads. Each search starts from an empty transposition
+// table, so that only the threads of that search fill it.
+static void engine_threads_time_to_depth(benchmark::State& state) {
+  const Board board = Board::from_fen("2r2r2/1Q2k1p1/p2p2q1/7p/P3Np2/7P/6P1/5R1K b - - 0 0");
+  const auto config = engine::uci::SearchConfig::from_depth(11).set_threads(static_cast<size_t>(state.range(0)));
+  int64_t node_count{0};
+  for (auto _ : state) {
+    state.PauseTiming();
+    Engine engine{board};
+    state.ResumeTiming();
+    auto move_info = engine.search_sync(config);
+    node_count += move_info.second.normal_node_count + move_info.second.quiescence_node_count;
+    benchmark::DoNotOptimize(move_info);
+  }
+  state.counters["nodes"] = benchmark::Counter(node_count, benchmark::Counter::kAvgIterations);
+  state.counters["nodes_per_second"] = benchmark::Counter(node_count, benchmark::Counter::kIsRate);
+}
+BENCHMARK(engine_threads_time_to_depth)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
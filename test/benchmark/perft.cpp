@@ -1,9 +1,12 @@
 #include <benchmark/benchmark.h>
 
 #include "chess/board.h"
+#include "chess/move_gen.h"
+#include "chess/slider_backend.h"
 
 using namespace chess;
 
+// Perft using copy-make (`Board::apply_move`).
 void search(const Board& board, size_t current_depth) {
   if (current_depth <= 0) return;
   auto moves = board.generate_moves();
@@ -12,6 +15,36 @@ void search(const Board& board, size_t current_depth) {
   }
 }
 
+// Perft using make/unmake (`Board::make_move` and `Board::unmake_move`) on a single board.
+void search_make_unmake(Board& board, size_t current_depth) {
+  if (current_depth <= 0) return;
+  auto moves = board.generate_moves();
+  for (const auto& move : moves) {
+    const Board::UndoInfo undo_info{board.make_move(move)};
+    search_make_unmake(board, current_depth - 1);
+    board.unmake_move(move, undo_info);
+  }
+}
+
+// Perft using copy-make, which counts the moves at the last ply (`Board::count_moves`) instead of generating them.
+uint64_t search_bulk_counting(const Board& board, size_t current_depth) {
+  if (current_depth <= 1) return current_depth == 0 ? 1 : board.count_moves();
+  uint64_t nodes{0};
+  for (const auto& move : board.generate_moves()) {
+    nodes += search_bulk_counting(board.apply_move(move), current_depth - 1);
+  }
+  return nodes;
+}
+
+// Perft using copy-make, which generates pseudo-legal moves and only checks the legality of the moves that are played.
+void search_pseudo_legal(const Board& board, size_t current_depth) {
+  if (current_depth <= 0) return;
+  for (const auto& move : move_gen::generate_pseudo_legal_moves(board)) {
+    if (!move_gen::is_pseudo_legal_move_legal(board, move)) continue;
+    search_pseudo_legal(board.apply_move(move), current_depth - 1);
+  }
+}
+
 static void perft_position_1(benchmark::State& state) {
   Board board = Board::initial();
   for (auto _ : state) {
@@ -58,4 +91,107 @@ static void perft_position_6(benchmark::State& state) {
     search(board, 5);
   }
 }
-BENCHMARK(perft_position_6);
\ No newline at end of file
+BENCHMARK(perft_position_6);
+
+static void perft_position_1_make_unmake(benchmark::State& state) {
+  Board board = Board::initial();
+  for (auto _ : state) {
+    search_make_unmake(board, 6);
+  }
+}
+BENCHMARK(perft_position_1_make_unmake);
+
+static void perft_position_2_make_unmake(benchmark::State& state) {
+  Board board = Board::from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 0");
+  for (auto _ : state) {
+    search_make_unmake(board, 5);
+  }
+}
+BENCHMARK(perft_position_2_make_unmake);
+
+static void perft_position_3_make_unmake(benchmark::State& state) {
+  Board board = Board::from_fen("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 0");
+  for (auto _ : state) {
+    search_make_unmake(board, 7);
+  }
+}
+BENCHMARK(perft_position_3_make_unmake);
+
+static void perft_position_4_make_unmake(benchmark::State& state) {
+  Board board = Board::from_fen("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq  0 0");
+  for (auto _ : state) {
+    search_make_unmake(board, 5);
+  }
+}
+BENCHMARK(perft_position_4_make_unmake);
+
+static void perft_position_5_make_unmake(benchmark::State& state) {
+  Board board = Board::from_fen("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 0 0");
+  for (auto _ : state) {
+    search_make_unmake(board, 5);
+  }
+}
+BENCHMARK(perft_position_5_make_unmake);
+
+static void perft_position_6_make_unmake(benchmark::State& state) {
+  Board board = Board::from_fen("r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 0");
+  for (auto _ : state) {
+    search_make_unmake(board, 5);
+  }
+}
+BENCHMARK(perft_position_6_make_unmake);
+
+static void perft_position_1_bulk_counting(benchmark::State& state) {
+  Board board = Board::initial();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(search_bulk_counting(board, 6));
+  }
+}
+BENCHMARK(perft_position_1_bulk_counting);
+
+static void perft_position_2_bulk_counting(benchmark::State& state) {
+  Board board = Board::from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 0");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(search_bulk_counting(board, 5));
+  }
+}
+BENCHMARK(perft_position_2_bulk_counting);
+
+static void perft_position_1_pseudo_legal(benchmark::State& state) {
+  Board board = Board::initial();
+  for (auto _ : state) {
+    search_pseudo_legal(board, 6);
+  }
+}
+BENCHMARK(perft_position_1_pseudo_legal);
+
+static void perft_position_2_pseudo_legal(benchmark::State& state) {
+  Board board = Board::from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 0");
+  for (auto _ : state) {
+    search_pseudo_legal(board, 5);
+  }
+}
+BENCHMARK(perft_position_2_pseudo_legal);
+
+// Perft from the initial position with the given slider attack backend.
+static void perft_slider_backend(benchmark::State& state, SliderBackend backend) {
+  if (!slider_backend::is_supported(backend)) {
+    state.SkipWithError("Slider backend is not supported on this CPU");
+    return;
+  }
+  const SliderBackend original_backend{slider_backend::get()};
+  slider_backend::set(backend);
+  Board board = Board::initial();
+  for (auto _ : state) {
+    search(board, 6);
+  }
+  slider_backend::set(original_backend);
+}
+
+static void perft_position_1_magic_backend(benchmark::State& state) {
+  perft_slider_backend(state, SliderBackend::Magic);
+}
+BENCHMARK(perft_position_1_magic_backend);
+
+static void perft_position_1_pext_backend(benchmark::State& state) { perft_slider_backend(state, SliderBackend::Pext); }
+BENCHMARK(perft_position_1_pext_backend);
\ No newline at end of file
@@ -2,13 +2,46 @@
 
 #include <doctest/doctest.h>
 
+#include <cstddef>
 #include <iostream>
 
+#include "chess/board_info.h"
+#include "chess/move_gen.h"
 #include "chess/stack_repetition_tracker.h"
 #include "chess/uci.h"
+#include "tree_walk.h"
 
 using namespace chess;
 
+namespace {
+// Checks that the type of the piece on each square (`Board::piece_at`) matches the players' bitboards.
+void check_mailbox(const Board& board) {
+  for (int index{0}; index < 64; index++) {
+    const auto bit{Bitboard::from_index(index)};
+    const auto white_piece{board.get_player<Color::White>().piece_at(bit)};
+    const auto black_piece{board.get_player<Color::Black>().piece_at(bit)};
+    REQUIRE(board.piece_at(bit) == (white_piece != PieceType::None ? white_piece : black_piece));
+  }
+}
+
+// Checks the mailbox of the given board and of all boards reachable from it within `depth` plies, which are reached
+// with `make_move` and restored with `unmake_move` on the given board.
+void check_mailbox_in_place(Board& board, size_t depth) {
+  check_mailbox(board);
+  if (depth == 0) return;
+  for (const Move& move : board.generate_moves()) {
+    const Board before{board};
+    const Board::UndoInfo undo_info{board.make_move(move)};
+    REQUIRE(board == before.apply_move(move));
+    check_mailbox_in_place(board, depth - 1);
+    board.unmake_move(move, undo_info);
+    REQUIRE(board == before);
+    REQUIRE(board.get_hash() == before.get_hash());
+    check_mailbox(board);
+  }
+}
+}  // namespace
+
 TEST_SUITE("board.from_fen") {
   TEST_CASE("castling rights") {
     auto board = Board::from_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 0");
@@ -45,6 +78,27 @@ TEST_SUITE("board.from_fen") {
     REQUIRE(!board.get_player<Color::Black>().can_castle_queenside());
     REQUIRE(board.get_en_passant() == Bitboard::D6);
   }
+
+  TEST_CASE("optional move counters") {
+    const auto board{Board::from_fen("rnbqkb1r/ppp1pppp/5n2/3pP3/8/8/PPPP1PPP/RNBQKBNR w - d6")};
+    REQUIRE(board == Board::from_fen("rnbqkb1r/ppp1pppp/5n2/3pP3/8/8/PPPP1PPP/RNBQKBNR w - d6 0 1"));
+    REQUIRE(Board::from_fen("8/8/8/8/8/8/8/K6k b - - 42 90").get_halfmove_clock() == 42);
+  }
+
+  TEST_CASE("invalid fen") {
+    std::string_view error;
+    REQUIRE(!Board::try_from_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP w KQkq - 0 1", &error));
+    REQUIRE(error == "invalid number of ranks");
+    REQUIRE(!Board::try_from_fen("rnbqkbnr/ppppxppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", &error));
+    REQUIRE(error == "invalid piece");
+    REQUIRE(!Board::try_from_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR x KQkq - 0 1", &error));
+    REQUIRE(error == "invalid side to move");
+    REQUIRE(!Board::try_from_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e4 0 1", &error));
+    REQUIRE(error == "invalid en passant square");
+    REQUIRE(!Board::try_from_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1 extra", &error));
+    REQUIRE_THROWS_AS(Board::from_fen("rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"),
+                      std::invalid_argument);
+  }
 }
 
 TEST_SUITE("board.get_hash") {
@@ -71,6 +125,125 @@ TEST_SUITE("board.get_hash") {
     auto black_turn_board{Board::from_fen("rnbqkbnr/ppppp1pp/8/4Pp2/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 0")};
     REQUIRE(white_turn_board.get_hash() != black_turn_board.get_hash());
   }
+
+  TEST_CASE("transpositions have equal hashes") {
+    auto board1{Board::initial()};
+    for (const auto uci_move : {"g1f3", "g8f6", "b1c3", "b8c6"}) {
+      board1 = board1.apply_move(uci::move(uci_move, board1));
+    }
+    auto board2{Board::initial()};
+    for (const auto uci_move : {"b1c3", "b8c6", "g1f3", "g8f6"}) {
+      board2 = board2.apply_move(uci::move(uci_move, board2));
+    }
+    REQUIRE(board1.get_hash() == board2.get_hash());
+  }
+
+  TEST_CASE("incremental hash matches recomputed hash") {
+    // Covers en passant, promotion with capture, captures that remove castling rights, and castling.
+    auto board{Board::from_fen("r3k2r/1P3ppp/8/8/5p2/8/4P1P1/R3K2R w KQkq - 0 0")};
+    for (const auto uci_move : {"e2e4", "f4e3", "b7a8q", "e8e7", "e1g1", "h8a8", "a1a8"}) {
+      board = board.apply_move(uci::move(uci_move, board));
+      REQUIRE(board.get_hash() == board.compute_hash());
+      REQUIRE(board.get_hash() == Board::from_fen(board.to_fen()).get_hash());
+    }
+    board = board.skip_turn();
+    REQUIRE(board.get_hash() == board.compute_hash());
+  }
+}
+
+TEST_SUITE("board.piece_at") {
+  TEST_CASE("initial board") {
+    const auto board{Board::initial()};
+    REQUIRE(board.piece_at(Bitboard::E1) == PieceType::King);
+    REQUIRE(board.piece_at(Bitboard::D8) == PieceType::Queen);
+    REQUIRE(board.piece_at(Bitboard::G8) == PieceType::Knight);
+    REQUIRE(board.piece_at(Bitboard::E4) == PieceType::None);
+  }
+
+  TEST_CASE("matches the players through make and unmake") {
+    // Between them, these positions have en passant, promotions (with and without captures) and castling.
+    for (const auto fen : {chess_test::perft_positions::position_2, chess_test::perft_positions::position_4,
+                           chess_test::perft_positions::position_5}) {
+      Board board{Board::from_fen(fen)};
+      check_mailbox_in_place(board, 3);
+    }
+    Board board{Board::from_fen(chess_test::perft_positions::position_3)};
+    check_mailbox_in_place(board, 4);
+  }
+}
+
+TEST_SUITE("board.attackers_to") {
+  TEST_CASE("attackers of both players") {
+    const auto board{Board::from_fen("4k3/8/3r4/4p3/3P4/5N2/8/4K3 w - - 0 0")};
+    const Bitboard occupied{board.get_player<Color::White>().occupied() | board.get_player<Color::Black>().occupied()};
+    REQUIRE(board.attackers_to(Bitboard::E5, occupied) == (Bitboard::D4 | Bitboard::F3));
+    REQUIRE(board.attackers_to(Bitboard::D4, occupied) == (Bitboard::D6 | Bitboard::E5 | Bitboard::F3));
+  }
+
+  TEST_CASE("x-rays are revealed by removing pieces from the occupancy") {
+    const auto board{Board::from_fen("4k3/3r4/8/3p4/8/8/3R4/3RK3 w - - 0 0")};
+    const Bitboard occupied{board.get_player<Color::White>().occupied() | board.get_player<Color::Black>().occupied()};
+    REQUIRE(board.attackers_to(Bitboard::D5, occupied) == (Bitboard::D2 | Bitboard::D7));
+    REQUIRE(board.attackers_to(Bitboard::D5, occupied ^ Bitboard::D2) == (Bitboard::D1 | Bitboard::D7));
+  }
+}
+
+TEST_SUITE("board.see") {
+  TEST_CASE("undefended piece") {
+    const auto board{Board::from_fen("1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 0")};
+    REQUIRE(board.see(uci::move("e1e5", board)) == 100);
+  }
+
+  TEST_CASE("defended piece") {
+    const auto board{Board::from_fen("1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 0")};
+    REQUIRE(board.see(uci::move("d3e5", board)) == -200);
+  }
+
+  TEST_CASE("x-ray recapture") {
+    const auto supported_board{Board::from_fen("4k3/3r4/8/3p4/8/8/3R4/3RK3 w - - 0 0")};
+    REQUIRE(supported_board.see(uci::move("d2d5", supported_board)) == 100);
+    const auto unsupported_board{Board::from_fen("4k3/3r4/8/3p4/8/8/8/3RK3 w - - 0 0")};
+    REQUIRE(unsupported_board.see(uci::move("d1d5", unsupported_board)) == -400);
+  }
+
+  TEST_CASE("quiet move to an attacked square") {
+    const auto board{Board::from_fen("4k3/8/8/3p4/8/8/8/2Q1K3 w - - 0 0")};
+    REQUIRE(board.see(uci::move("c1c4", board)) == -900);
+    REQUIRE(board.see(uci::move("c1c3", board)) == 0);
+  }
+
+  TEST_CASE("king cannot recapture a defended piece") {
+    const auto defended_board{Board::from_fen("8/8/8/3k4/4p3/3P4/5N2/4K3 w - - 0 0")};
+    REQUIRE(defended_board.see(uci::move("d3e4", defended_board)) == 100);
+    const auto undefended_board{Board::from_fen("8/8/8/3k4/4p3/3P4/8/4K3 w - - 0 0")};
+    REQUIRE(undefended_board.see(uci::move("d3e4", undefended_board)) == 0);
+  }
+
+  TEST_CASE("en passant and promotion") {
+    const auto en_passant_board{Board::from_fen("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 0")};
+    REQUIRE(en_passant_board.see(uci::move("e5d6", en_passant_board)) == 100);
+    const auto promotion_board{Board::from_fen("4k3/1P6/8/8/8/8/8/4K3 w - - 0 0")};
+    REQUIRE(promotion_board.see(uci::move("b7b8q", promotion_board)) == 800);
+  }
+}
+
+TEST_SUITE("board_info") {
+  TEST_CASE("pinned pieces") {
+    const auto board{Board::from_fen("4r2k/8/8/8/1b6/8/3NN3/4K3 w - - 0 0")};
+    const BoardInfo info{board};
+    REQUIRE(!info.is_in_check());
+    REQUIRE(info.get_pinners() == (Bitboard::B4 | Bitboard::E8));
+    REQUIRE(info.get_pinned_pieces() == (Bitboard::D2 | Bitboard::E2));
+  }
+
+  TEST_CASE("sliders attack through the king in check") {
+    const auto board{Board::from_fen("4r2k/8/8/8/8/8/4K3/8 w - - 0 0")};
+    const BoardInfo info{board};
+    REQUIRE(info.is_in_check());
+    REQUIRE(info.get_checkers() == Bitboard::E8);
+    REQUIRE(!info.get_pinners());
+    REQUIRE(info.get_opp_attacks() & Bitboard::E1);
+  }
 }
 
 TEST_SUITE("board.get_score") {
@@ -121,6 +294,30 @@ TEST_SUITE("board.get_score") {
   }
 }
 
+TEST_SUITE("move_gen.generate_moves_and_score") {
+  TEST_CASE("game not over") {
+    const auto board{Board::initial()};
+    const auto [moves, score] = move_gen::generate_moves_and_score(board);
+    REQUIRE(!score.has_value());
+    REQUIRE(moves.size() == 20);
+    const auto [quiescence_moves, quiescence_score] = move_gen::generate_quiescence_moves_and_score(board);
+    REQUIRE(!quiescence_score.has_value());
+    REQUIRE(quiescence_moves.empty());
+  }
+
+  TEST_CASE("checkmate") {
+    const auto board{Board::from_fen("rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3")};
+    REQUIRE(move_gen::generate_moves_and_score(board).score == -1);
+    REQUIRE(move_gen::generate_quiescence_moves_and_score(board).score == -1);
+  }
+
+  TEST_CASE("stalemate") {
+    const auto board{Board::from_fen("7k/5Q2/6K1/8/8/8/8/8 b - - 0 0")};
+    REQUIRE(move_gen::generate_moves_and_score(board).score == 0);
+    REQUIRE(move_gen::generate_quiescence_moves_and_score(board).score == 0);
+  }
+}
+
 TEST_SUITE("board.to_fen") {
   TEST_CASE("from initial board") {
     auto board = chess::Board::initial();
@@ -0,0 +1,130 @@
+#include "chess/fixed_repetition_tracker.h"
+
+#include <doctest/doctest.h>
+
+#include <string_view>
+#include <vector>
+
+#include "chess/board.h"
+#include "chess/stack_repetition_tracker.h"
+#include "chess/uci.h"
+
+using namespace chess;
+
+TEST_SUITE("fixed_repetition_tracker") {
+  // Plays the given uci moves from `board`, visiting each position in `tracker`.
+  void play(Board & board, FixedRepetitionTracker & tracker, const std::vector<std::string_view>& moves) {
+    for (const auto uci_move : moves) {
+      const Move move{uci::move(uci_move, board)};
+      board = board.apply_move(move);
+      tracker.push(board, move);
+    }
+  }
+
+  TEST_CASE("draw by repetition") {
+    Board board{Board::initial()};
+    FixedRepetitionTracker tracker{};
+    tracker.push(board);
+    play(board, tracker, {"b1c3", "b8c6", "c3b1", "c6b8", "b1c3", "b8c6", "c3b1"});
+    REQUIRE_FALSE(tracker.is_repetition_draw());
+    play(board, tracker, {"c6b8"});
+    REQUIRE(tracker.is_repetition_draw());
+    tracker.pop();
+    REQUIRE_FALSE(tracker.is_repetition_draw());
+  }
+
+  TEST_CASE("irreversible moves") {
+    Board board{Board::initial()};
+    FixedRepetitionTracker tracker{};
+    tracker.push(board);
+    play(board, tracker, {"b1c3", "b8c6", "c3b1", "c6b8", "e2e4", "e7e5"});
+    play(board, tracker, {"b1c3", "b8c6", "c3b1", "c6b8", "b1c3", "b8c6", "c3b1", "c6b8"});
+    // The position after e7e5 differs from the later ones, as it has an en passant square.
+    REQUIRE_FALSE(tracker.is_repetition_draw());
+    play(board, tracker, {"b1c3", "b8c6", "c3b1", "c6b8"});
+    REQUIRE(tracker.is_repetition_draw());
+
+    // Positions are not repeated across a skipped turn.
+    board = Board::initial();
+    tracker = FixedRepetitionTracker{};
+    tracker.push(board);
+    play(board, tracker, {"b1c3", "b8c6", "c3b1", "c6b8"});
+    board = board.skip_turn().skip_turn();
+    tracker.push(board);
+    play(board, tracker, {"b1c3", "b8c6", "c3b1", "c6b8"});
+    REQUIRE_FALSE(tracker.is_repetition_draw());
+  }
+
+  TEST_CASE("same as stack repetition tracker when full") {
+    Board board{Board::initial()};
+    FixedRepetitionTracker tracker{};
+    StackRepetitionTracker stack_tracker{};
+    tracker.push(board);
+    stack_tracker.push(board);
+    const std::vector<std::string_view> moves{"g1f3", "g8f6", "f3g1", "f6g8", "b1c3", "b8c6", "c3b1", "c6b8"};
+    for (size_t i{0}; i < 3 * FixedRepetitionTracker::capacity; i++) {
+      const Move move{uci::move(moves[i % moves.size()], board)};
+      board = board.apply_move(move);
+      tracker.push(board, move);
+      stack_tracker.push(board, move);
+      REQUIRE(tracker.is_repetition_draw() == stack_tracker.is_repetition_draw());
+      REQUIRE(tracker.ply() == i + 2);
+    }
+  }
+
+  TEST_CASE("unvisit past an irreversible move when full") {
+    Board board{Board::initial()};
+    FixedRepetitionTracker tracker{};
+    StackRepetitionTracker stack_tracker{};
+    tracker.push(board);
+    stack_tracker.push(board);
+    const std::vector<std::string_view> moves{"g1f3", "g8f6", "f3g1", "f6g8", "b1c3", "b8c6", "c3b1", "c6b8"};
+    for (size_t i{0}; i + 1 < FixedRepetitionTracker::capacity; i++) {
+      const Move move{uci::move(moves[i % moves.size()], board)};
+      board = board.apply_move(move);
+      tracker.push(board, move);
+      stack_tracker.push(board, move);
+    }
+    REQUIRE(tracker.ply() == FixedRepetitionTracker::capacity);
+
+    // The pawn move is visited while the tracker is full, then the positions before it are unvisited again.
+    const Move move{uci::move("e2e4", board)};
+    tracker.push(board.apply_move(move), move);
+    stack_tracker.push(board.apply_move(move), move);
+    REQUIRE_FALSE(tracker.is_repetition_draw());
+    for (size_t i{0}; i < FixedRepetitionTracker::capacity / 4; i++) {
+      tracker.pop();
+      stack_tracker.pop();
+      REQUIRE(tracker.is_repetition_draw() == stack_tracker.is_repetition_draw());
+      REQUIRE(tracker.ply() == FixedRepetitionTracker::capacity - i);
+    }
+  }
+
+  TEST_CASE("upcoming repetition") {
+    Board board{Board::initial()};
+    FixedRepetitionTracker tracker{};
+    tracker.push(board);
+    play(board, tracker, {"g1f3", "g8f6", "f3g5"});
+    // Black can only repeat a position by moving twice.
+    REQUIRE_FALSE(tracker.has_upcoming_repetition(board, 3));
+    play(board, tracker, {"f6g8"});
+    // White can repeat the position after 1. Nf3 with Ng5-f3, which was visited once.
+    REQUIRE(tracker.has_upcoming_repetition(board, 4));
+    REQUIRE_FALSE(tracker.has_upcoming_repetition(board, 0));
+    play(board, tracker, {"g5f3", "g8f6", "f3g5", "f6g8"});
+    // Now the position after 1. Nf3 was visited twice.
+    REQUIRE(tracker.has_upcoming_repetition(board, 0));
+
+    // The repeating move must not be blocked.
+    board = Board::from_fen("4k3/8/8/8/8/7n/8/1R2K3 w - - 0 1");
+    tracker = FixedRepetitionTracker{};
+    tracker.push(board);
+    play(board, tracker, {"b1a1", "e8d8", "a1b1", "d8c8", "b1b5", "c8d8", "b5a5", "d8e8"});
+    REQUIRE(tracker.has_upcoming_repetition(board, 8));
+    board = Board::from_fen("4k3/8/8/8/8/n7/8/1R2K3 w - - 0 1");
+    tracker = FixedRepetitionTracker{};
+    tracker.push(board);
+    play(board, tracker, {"b1a1", "e8d8", "a1b1", "d8c8", "b1b5", "c8d8", "b5a5", "d8e8"});
+    REQUIRE_FALSE(tracker.has_upcoming_repetition(board, 8));
+  }
+}
@@ -0,0 +1,41 @@
+#include "chess/kpk.h"
+
+#include <doctest/doctest.h>
+
+#include "chess/board.h"
+
+using namespace chess;
+
+TEST_SUITE("kpk") {
+  TEST_CASE("not king and pawn vs king") {
+    REQUIRE_FALSE(kpk::probe(Board::initial()).has_value());
+    REQUIRE_FALSE(kpk::probe(Board::from_fen("8/8/8/8/8/4k3/4N3/4K3 w - - 0 1")).has_value());
+    REQUIRE_FALSE(kpk::probe(Board::from_fen("8/8/8/8/8/4k3/4PP2/4K3 w - - 0 1")).has_value());
+  }
+
+  TEST_CASE("wins") {
+    // The king is in front of the pawn on the sixth rank.
+    REQUIRE(kpk::probe(Board::from_fen("4k3/8/4K3/4P3/8/8/8/8 b - - 0 1")).value());
+    REQUIRE(kpk::probe(Board::from_fen("4k3/8/4K3/4P3/8/8/8/8 w - - 0 1")).value());
+    REQUIRE(kpk::probe(Board::from_fen("8/8/8/8/4p3/4k3/8/4K3 w - - 0 1")).value());
+    // The defending king is outside the square of the pawn.
+    REQUIRE(kpk::probe(Board::from_fen("8/k7/8/7P/8/8/8/K7 b - - 0 1")).value());
+    REQUIRE(kpk::probe(Board::from_fen("8/3k4/8/7P/8/8/8/K7 w - - 0 1")).value());
+    // The pawn promotes and the queen cannot be captured.
+    REQUIRE(kpk::probe(Board::from_fen("8/1P1k4/8/1K6/8/8/8/8 w - - 0 1")).value());
+  }
+
+  TEST_CASE("draws") {
+    // The defending king keeps the opposition.
+    REQUIRE_FALSE(kpk::probe(Board::from_fen("8/8/8/8/8/4k3/4P3/4K3 w - - 0 1")).value());
+    // The defending king is in the corner in front of a rook pawn.
+    REQUIRE_FALSE(kpk::probe(Board::from_fen("k7/8/K7/P7/8/8/8/8 w - - 0 1")).value());
+    REQUIRE_FALSE(kpk::probe(Board::from_fen("8/8/8/8/p7/k7/8/K7 b - - 0 1")).value());
+    // The defending king is inside the square of the pawn.
+    REQUIRE_FALSE(kpk::probe(Board::from_fen("8/3k4/8/7P/8/8/8/K7 b - - 0 1")).value());
+    // The pawn is captured.
+    REQUIRE_FALSE(kpk::probe(Board::from_fen("8/8/8/8/3kP3/8/8/K7 b - - 0 1")).value());
+    // Stalemate.
+    REQUIRE_FALSE(kpk::probe(Board::from_fen("k7/P7/1K6/8/8/8/8/8 b - - 0 1")).value());
+  }
+}
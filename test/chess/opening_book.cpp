@@ -0,0 +1,144 @@
+#include "chess/opening_book.h"
+
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "chess/board.h"
+#include "chess/uci.h"
+
+using namespace chess;
+
+namespace {
+// Writes a book with the given {board, move, weight} entries to a temporary file, and returns its path.
+std::filesystem::path write_book(std::vector<std::tuple<Board, uint16_t, uint16_t>> entries) {
+  std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+    return OpeningBook::get_key(std::get<0>(a)) < OpeningBook::get_key(std::get<0>(b));
+  });
+  const std::filesystem::path path{std::filesystem::temp_directory_path() / "chess_opening_book_test.bin"};
+  std::ofstream file{path, std::ios::binary};
+  for (const auto& [board, move, weight] : entries) {
+    std::array<char, OpeningBook::entry_size> data{};
+    const uint64_t key{OpeningBook::get_key(board)};
+    for (size_t i{0}; i < 8; i++) data[i] = static_cast<char>(key >> (56 - 8 * i));
+    data[8] = static_cast<char>(move >> 8);
+    data[9] = static_cast<char>(move);
+    data[10] = static_cast<char>(weight >> 8);
+    data[11] = static_cast<char>(weight);
+    file.write(data.data(), data.size());
+  }
+  return path;
+}
+
+uint16_t encode(std::string_view uci_move, const Board& board) {
+  return OpeningBook::encode_move(uci::move(uci_move, board));
+}
+}  // namespace
+
+TEST_SUITE("opening book") {
+  TEST_CASE("move encoding") {
+    const Board initial{Board::initial()};
+    // e2 is square 12 and e4 is square 28.
+    REQUIRE(encode("e2e4", initial) == (12 << 6 | 28));
+    const Board castling{Board::from_fen("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1")};
+    // Castling is encoded as the king moving onto its rook.
+    REQUIRE(encode("e1g1", castling) == (4 << 6 | 7));
+    REQUIRE(encode("e1c1", castling) == (4 << 6 | 0));
+    const Board promotion{Board::from_fen("8/1P6/8/8/8/8/8/k6K w - - 0 1")};
+    REQUIRE(encode("b7b8n", promotion) == (1 << 12 | 49 << 6 | 57));
+    REQUIRE(encode("b7b8q", promotion) == (4 << 12 | 49 << 6 | 57));
+  }
+
+  TEST_CASE("keys") {
+    const auto play = [](std::string_view fen, const std::vector<std::string_view>& moves) {
+      Board board{Board::from_fen(fen)};
+      for (const std::string_view move : moves) board = board.apply_move(uci::move(move, board));
+      return board;
+    };
+    const std::string_view initial{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"};
+
+    // Transpositions have the same key.
+    REQUIRE(OpeningBook::get_key(play(initial, {"g1f3", "g8f6", "b1c3", "b8c6"})) ==
+            OpeningBook::get_key(play(initial, {"b1c3", "b8c6", "g1f3", "g8f6"})));
+    // The side to move and castling rights are part of the key.
+    REQUIRE(OpeningBook::get_key(play(initial, {})) !=
+            OpeningBook::get_key(Board::from_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR b KQkq - 0 1")));
+    REQUIRE(OpeningBook::get_key(play(initial, {})) !=
+            OpeningBook::get_key(Board::from_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w Kkq - 0 1")));
+
+    // The en passant square only counts if a pawn of the current player is next to the pawn that moved two squares.
+    REQUIRE(OpeningBook::get_key(play(initial, {"e2e4"})) ==
+            OpeningBook::get_key(Board::from_fen("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1")));
+    const std::string_view french_advance{"rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq - 0 1"};
+    REQUIRE(OpeningBook::get_key(play(initial, {"e2e4", "d7d5", "e4e5", "f7f5"})) !=
+            OpeningBook::get_key(Board::from_fen(french_advance)));
+    REQUIRE(OpeningBook::get_key(play(initial, {"e2e4", "d7d5", "e4e5", "f7f5"})) ==
+            OpeningBook::get_key(Board::from_fen("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 1")));
+    // It counts even if the capture is illegal (here as it would expose the king to the rook), as in Polyglot.
+    const Board pinned{play("8/8/8/8/k1p4R/8/3P4/4K3 w - - 0 1", {"d2d4"})};
+    REQUIRE(OpeningBook::get_key(pinned) != OpeningBook::get_key(Board::from_fen("8/8/8/8/k1pP3R/8/8/4K3 b - - 0 1")));
+  }
+
+  TEST_CASE("probing") {
+    const Board initial{Board::initial()};
+    const Board after_e4{initial.apply_move(uci::move("e2e4", initial))};
+    const Board castling{Board::from_fen("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1")};
+    const OpeningBook book{write_book({
+        {initial, encode("e2e4", initial), 3},
+        {initial, encode("d2d4", initial), 1},
+        {initial, 12 << 6 | 36, 5},  // e2e5, which is not a legal move.
+        {after_e4, encode("c7c5", after_e4), 0},
+        {castling, encode("e1g1", castling), 1},
+    })};
+
+    const std::vector<OpeningBook::Entry> entries{book.get_entries(initial)};
+    REQUIRE(entries.size() == 2);
+    REQUIRE(entries[0].move.to_uci() + entries[1].move.to_uci() == "e2e4d2d4");
+    REQUIRE(entries[0].weight + entries[1].weight == 4);
+
+    REQUIRE(book.get_entries(castling).at(0).move.is_castle());
+    REQUIRE(book.get_entries(Board::from_fen("8/8/8/3k4/8/8/2K5/8 w - - 0 1")).empty());
+
+    // Moves with no weight are never chosen.
+    std::mt19937_64 random{0};
+    REQUIRE_FALSE(book.choose_move(after_e4, random).has_value());
+
+    int e4_count{0};
+    for (int i{0}; i < 1000; i++) {
+      const std::optional<Move> move{book.choose_move(initial, random)};
+      REQUIRE(move.has_value());
+      if (move->to_uci() == "e2e4") e4_count++;
+    }
+    // e2e4 should be chosen about 750 times.
+    REQUIRE(e4_count > 650);
+    REQUIRE(e4_count < 850);
+  }
+
+  TEST_CASE("writing") {
+    const Board initial{Board::initial()};
+    const Board after_d4{initial.apply_move(uci::move("d2d4", initial))};
+    const std::filesystem::path path{std::filesystem::temp_directory_path() / "chess_opening_book_test.bin"};
+    OpeningBook::write(path, {
+                                 {OpeningBook::get_key(after_d4), encode("g8f6", after_d4), 2},
+                                 {OpeningBook::get_key(initial), encode("d2d4", initial), 1},
+                                 {OpeningBook::get_key(initial), encode("e2e4", initial), 7},
+                             });
+    const OpeningBook book{path};
+    // Moves of the same position are stored from the highest weight.
+    const std::vector<OpeningBook::Entry> entries{book.get_entries(initial)};
+    REQUIRE(entries.size() == 2);
+    REQUIRE(entries[0].move.to_uci() == "e2e4");
+    REQUIRE(entries[0].weight == 7);
+    REQUIRE(entries[1].move.to_uci() == "d2d4");
+    REQUIRE(book.get_entries(after_d4).at(0).move.to_uci() == "g8f6");
+  }
+}
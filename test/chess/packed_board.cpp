@@ -0,0 +1,52 @@
+#include "chess/packed_board.h"
+
+#include <doctest/doctest.h>
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "chess/board.h"
+#include "chess/move.h"
+#include "tree_walk.h"
+
+using namespace chess;
+
+namespace {
+// Checks that the given board, and all boards reachable from it within `depth` plies, are unpacked to the boards that
+// were packed.
+void check_round_trip(const Board& board, size_t depth) {
+  const auto check = [](const Board& position) {
+    const Board unpacked{PackedBoard::pack(position).unpack()};
+    REQUIRE(unpacked == position);
+    REQUIRE(unpacked.get_hash() == position.get_hash());
+  };
+  check(board);
+  chess_test::for_each_move(board, depth,
+                            [&check](const Board& parent, const Move& move) { check(parent.apply_move(move)); });
+}
+}  // namespace
+
+TEST_SUITE("packed_board") {
+  TEST_CASE("initial board") {
+    static_assert(PackedBoard::pack(Board::initial()).unpack() == Board::initial());
+    check_round_trip(Board::initial(), 3);
+  }
+
+  TEST_CASE("castling rights, en passant and halfmove clock") {
+    check_round_trip(Board::from_fen(chess_test::perft_positions::position_2), 3);
+    check_round_trip(Board::from_fen("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w Kq f6 0 0"), 1);
+    check_round_trip(Board::from_fen("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 b - - 57 0"), 1);
+  }
+
+  TEST_CASE("copied as bytes") {
+    const Board board{Board::from_fen("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 3 0")};
+    const PackedBoard packed{PackedBoard::pack(board)};
+    std::array<char, sizeof(PackedBoard)> bytes;
+    std::memcpy(bytes.data(), &packed, sizeof(PackedBoard));
+    PackedBoard copied;
+    std::memcpy(&copied, bytes.data(), sizeof(PackedBoard));
+    REQUIRE(copied == packed);
+    REQUIRE(copied.unpack() == board);
+  }
+}
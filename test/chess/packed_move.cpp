@@ -0,0 +1,36 @@
+#include "chess/packed_move.h"
+
+#include <doctest/doctest.h>
+
+#include <cstddef>
+
+#include "chess/board.h"
+#include "chess/move.h"
+#include "tree_walk.h"
+
+using namespace chess;
+
+namespace {
+// Checks that all moves reachable within `depth` plies are unpacked to the moves that were packed.
+void check_round_trip(const Board& board, size_t depth) {
+  chess_test::for_each_move(board, depth, [](const Board& parent, const Move& move) {
+    REQUIRE(PackedMove::pack(move).unpack(parent) == move);
+  });
+}
+}  // namespace
+
+TEST_SUITE("packed_move") {
+  TEST_CASE("null move") {
+    static_assert(PackedMove::pack(Move::null()).is_null());
+    static_assert(PackedMove{}.unpack(Board::initial()).is_null());
+    REQUIRE_FALSE(PackedMove::pack(Board::initial().generate_moves()[0]).is_null());
+  }
+
+  TEST_CASE("castling, en passant and promotions") {
+    check_round_trip(Board::initial(), 3);
+    check_round_trip(Board::from_fen(chess_test::perft_positions::position_2), 3);
+    check_round_trip(Board::from_fen(chess_test::perft_positions::position_3), 4);
+    check_round_trip(Board::from_fen(chess_test::perft_positions::position_4), 3);
+    check_round_trip(Board::from_fen(chess_test::perft_positions::position_5), 3);
+  }
+}
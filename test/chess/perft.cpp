@@ -1,10 +1,13 @@
 #include <doctest/doctest.h>
 
+#include <algorithm>
 #include <functional>
 #include <iostream>
+#include <span>
 
 #include "chess/board.h"
 #include "chess/move.h"
+#include "chess/move_gen.h"
 
 using namespace chess;
 
@@ -17,6 +20,7 @@ TEST_SUITE("perft move generation") {
     if (depth + 1 >= node_count.size()) return;
     auto moves = board.generate_moves();
     REQUIRE(board.has_moves() == !moves.empty());
+    REQUIRE(board.count_moves() == moves.size());
     for (const auto& move : moves) {
       search(node_count, board.apply_move(move), depth + 1);
     }
@@ -76,6 +80,16 @@ TEST_SUITE("perft quiescence move generation") {
     if (depth >= max_depth) return;
     auto moves = board.generate_moves();
     REQUIRE(board.has_moves() == !moves.empty());
+
+    // The moves and score generated in a single pass match those generated separately.
+    const auto [all_moves, score] = move_gen::generate_moves_and_score(board);
+    REQUIRE(score == board.get_score());
+    if (!score) REQUIRE(all_moves.size() == moves.size());
+    const auto [quiescence_moves, quiescence_score] = move_gen::generate_quiescence_moves_and_score(board);
+    REQUIRE(quiescence_score == score);
+    if (!score && board.is_in_check()) REQUIRE(quiescence_moves.size() == moves.size());
+    if (!score && !board.is_in_check()) REQUIRE(quiescence_moves.size() == board.generate_quiescence_moves().size());
+
     if (!board.is_in_check()) {
       auto captures_and_promotions = board.generate_quiescence_moves();
       auto captures_checks_and_promotions = board.generate_quiescence_moves_and_checks();
@@ -129,4 +143,205 @@ TEST_SUITE("perft quiescence move generation") {
     const Board board = Board::from_fen("r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 0");
     search_quiescence(board, 0, 4);
   }
-}
\ No newline at end of file
+}
+
+TEST_SUITE("perft staged move generation") {
+  bool contains(MoveContainer & moves, const Move& move) {
+    return std::find(moves.begin(), moves.end(), move) != moves.end();
+  }
+
+  // `other_moves` are moves from the parent position, which are used as (possibly illegal) hash and killer moves.
+  void search_staged(const Board& board, MoveContainer& other_moves, size_t depth, size_t max_depth) {
+    if (depth >= max_depth) return;
+    auto moves = board.generate_moves();
+
+    // Verify that `is_legal` accepts exactly the legal moves.
+    for (const auto& move : moves) REQUIRE(move_gen::is_legal(board, move));
+    for (const auto& move : other_moves) REQUIRE(move_gen::is_legal(board, move) == contains(moves, move));
+
+    // Verify that every legal move is generated exactly once, with the hash move first.
+    const Move hash_move = other_moves.empty() ? Move::null() : other_moves[other_moves.size() / 2];
+    const BoardInfo info{board};
+    StagedMoveGen staged_move_gen{info, hash_move, std::span<Move>{other_moves.begin(), other_moves.end()}};
+    size_t staged_moves_count{0};
+    for (MoveContainer staged_moves; staged_move_gen.next_stage(staged_moves);) {
+      if (staged_move_gen.get_stage() == StagedMoveGen::Stage::HashMove) REQUIRE(staged_moves_count == 0);
+      for (const auto& move : staged_moves) {
+        REQUIRE(contains(moves, move));
+        if (staged_move_gen.get_stage() == StagedMoveGen::Stage::HashMove) REQUIRE(move == hash_move);
+        if (staged_move_gen.get_stage() == StagedMoveGen::Stage::GoodCapturesAndPromotions) {
+          REQUIRE((move.is_promotion() || (move.is_capture() && board.see(move) >= 0)));
+        }
+        if (staged_move_gen.get_stage() == StagedMoveGen::Stage::QuietMovesAndBadCaptures) {
+          REQUIRE(!move.is_promotion());
+          REQUIRE((!move.is_capture() || board.see(move) < 0));
+        }
+      }
+      staged_moves_count += staged_moves.size();
+    }
+    REQUIRE(staged_moves_count == moves.size());
+    REQUIRE(staged_move_gen.get_stage() == StagedMoveGen::Stage::Done);
+
+    for (const auto& move : moves) {
+      search_staged(board.apply_move(move), moves, depth + 1, max_depth);
+    }
+  }
+
+  TEST_CASE("perft initial position - staged") {
+    const Board board = Board::initial();
+    MoveContainer no_moves{};
+    search_staged(board, no_moves, 0, 5);
+  }
+
+  TEST_CASE("perft position 2 - staged") {
+    const Board board = Board::from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 0");
+    MoveContainer no_moves{};
+    search_staged(board, no_moves, 0, 4);
+  }
+
+  TEST_CASE("perft position 3 - staged") {
+    const Board board = Board::from_fen("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 0");
+    MoveContainer no_moves{};
+    search_staged(board, no_moves, 0, 6);
+  }
+
+  TEST_CASE("perft position 4 - staged") {
+    const Board board = Board::from_fen("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 0");
+    MoveContainer no_moves{};
+    search_staged(board, no_moves, 0, 5);
+  }
+
+  TEST_CASE("perft position 5 - staged") {
+    const Board board = Board::from_fen("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 0 0");
+    MoveContainer no_moves{};
+    search_staged(board, no_moves, 0, 4);
+  }
+}
+
+TEST_SUITE("perft make/unmake move generation") {
+  // Perft using make/unmake, which also checks that each move is made identically to `apply_move`, and that
+  // unmaking it restores the original board.
+  void search_make_unmake(std::vector<int> & node_count, Board & board, size_t depth) {
+    node_count[depth]++;
+    if (depth + 1 >= node_count.size()) return;
+    const Board original_board{board};
+    for (const auto& move : board.generate_moves()) {
+      const Board::UndoInfo undo_info{board.make_move(move)};
+      const Board applied_board{original_board.apply_move(move)};
+      REQUIRE(board == applied_board);
+      REQUIRE(board.get_hash() == applied_board.get_hash());
+      search_make_unmake(node_count, board, depth + 1);
+      board.unmake_move(move, undo_info);
+      REQUIRE(board == original_board);
+      REQUIRE(board.get_hash() == original_board.get_hash());
+    }
+  }
+
+  TEST_CASE("perft initial position - make/unmake") {
+    Board board = Board::initial();
+    const std::vector<int> correct_node_count = {1, 20, 400, 8902, 197281};
+    std::vector<int> node_count(correct_node_count.size(), 0);
+    search_make_unmake(node_count, board, 0);
+    for (size_t i = 0; i < node_count.size(); i++) REQUIRE(node_count[i] == correct_node_count[i]);
+  }
+
+  TEST_CASE("perft position 2 - make/unmake") {
+    Board board = Board::from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 0");
+    const std::vector<int> correct_node_count = {1, 48, 2039, 97862};
+    std::vector<int> node_count(correct_node_count.size(), 0);
+    search_make_unmake(node_count, board, 0);
+    for (size_t i = 0; i < node_count.size(); i++) REQUIRE(node_count[i] == correct_node_count[i]);
+  }
+
+  TEST_CASE("perft position 3 - make/unmake") {
+    Board board = Board::from_fen("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 0");
+    const std::vector<int> correct_node_count = {1, 14, 191, 2812, 43238, 674624};
+    std::vector<int> node_count(correct_node_count.size(), 0);
+    search_make_unmake(node_count, board, 0);
+    for (size_t i = 0; i < node_count.size(); i++) REQUIRE(node_count[i] == correct_node_count[i]);
+  }
+
+  TEST_CASE("perft position 4 - make/unmake") {
+    Board board = Board::from_fen("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 0");
+    const std::vector<int> correct_node_count = {1, 6, 264, 9467, 422333};
+    std::vector<int> node_count(correct_node_count.size(), 0);
+    search_make_unmake(node_count, board, 0);
+    for (size_t i = 0; i < node_count.size(); i++) REQUIRE(node_count[i] == correct_node_count[i]);
+  }
+
+  TEST_CASE("perft position 5 - make/unmake") {
+    Board board = Board::from_fen("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 0 0");
+    const std::vector<int> correct_node_count = {1, 44, 1486, 62379};
+    std::vector<int> node_count(correct_node_count.size(), 0);
+    search_make_unmake(node_count, board, 0);
+    for (size_t i = 0; i < node_count.size(); i++) REQUIRE(node_count[i] == correct_node_count[i]);
+  }
+}
+
+TEST_SUITE("perft pseudo-legal move generation") {
+  // Perft using pseudo-legal moves that are filtered by `is_pseudo_legal_move_legal`, which also checks that the
+  // filtered moves are exactly the legal moves.
+  void search_pseudo_legal(std::vector<int> & node_count, const Board& board, size_t depth) {
+    node_count[depth]++;
+    if (depth + 1 >= node_count.size()) return;
+    auto legal_moves = board.generate_moves();
+    MoveContainer moves;
+    for (const auto& move : move_gen::generate_pseudo_legal_moves(board)) {
+      if (move_gen::is_pseudo_legal_move_legal(board, move)) moves.push_back(move);
+    }
+    REQUIRE(moves.size() == legal_moves.size());
+    for (const auto& move : moves) {
+      REQUIRE(std::find(legal_moves.begin(), legal_moves.end(), move) != legal_moves.end());
+    }
+
+    if (!board.is_in_check()) {
+      size_t quiescence_moves_count{0};
+      for (const auto& move : move_gen::generate_pseudo_legal_quiescence_moves(board)) {
+        if (move_gen::is_pseudo_legal_move_legal(board, move)) quiescence_moves_count++;
+      }
+      REQUIRE(quiescence_moves_count == board.generate_quiescence_moves().size());
+    }
+
+    for (const auto& move : moves) search_pseudo_legal(node_count, board.apply_move(move), depth + 1);
+  }
+
+  TEST_CASE("perft initial position - pseudo-legal") {
+    const Board board = Board::initial();
+    const std::vector<int> correct_node_count = {1, 20, 400, 8902, 197281};
+    std::vector<int> node_count(correct_node_count.size(), 0);
+    search_pseudo_legal(node_count, board, 0);
+    for (size_t i = 0; i < node_count.size(); i++) REQUIRE(node_count[i] == correct_node_count[i]);
+  }
+
+  TEST_CASE("perft position 2 - pseudo-legal") {
+    const Board board = Board::from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 0");
+    const std::vector<int> correct_node_count = {1, 48, 2039, 97862};
+    std::vector<int> node_count(correct_node_count.size(), 0);
+    search_pseudo_legal(node_count, board, 0);
+    for (size_t i = 0; i < node_count.size(); i++) REQUIRE(node_count[i] == correct_node_count[i]);
+  }
+
+  TEST_CASE("perft position 3 - pseudo-legal") {
+    const Board board = Board::from_fen("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 0");
+    const std::vector<int> correct_node_count = {1, 14, 191, 2812, 43238, 674624};
+    std::vector<int> node_count(correct_node_count.size(), 0);
+    search_pseudo_legal(node_count, board, 0);
+    for (size_t i = 0; i < node_count.size(); i++) REQUIRE(node_count[i] == correct_node_count[i]);
+  }
+
+  TEST_CASE("perft position 4 - pseudo-legal") {
+    const Board board = Board::from_fen("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 0");
+    const std::vector<int> correct_node_count = {1, 6, 264, 9467, 422333};
+    std::vector<int> node_count(correct_node_count.size(), 0);
+    search_pseudo_legal(node_count, board, 0);
+    for (size_t i = 0; i < node_count.size(); i++) REQUIRE(node_count[i] == correct_node_count[i]);
+  }
+
+  TEST_CASE("perft position 5 - pseudo-legal") {
+    const Board board = Board::from_fen("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 0 0");
+    const std::vector<int> correct_node_count = {1, 44, 1486, 62379};
+    std::vector<int> node_count(correct_node_count.size(), 0);
+    search_pseudo_legal(node_count, board, 0);
+    for (size_t i = 0; i < node_count.size(); i++) REQUIRE(node_count[i] == correct_node_count[i]);
+  }
+}
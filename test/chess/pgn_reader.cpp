@@ -0,0 +1,158 @@
+#include "chess/pgn_reader.h"
+
+#include <doctest/doctest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "chess/board.h"
+
+using namespace chess;
+
+namespace {
+// Writes `contents` to a temporary file and returns its path.
+std::filesystem::path write_pgn(std::string_view contents) {
+  const auto path{std::filesystem::temp_directory_path() / "chess_pgn_reader_test.pgn"};
+  std::ofstream{path} << contents;
+  return path;
+}
+
+// Returns the moves of the game in UCI notation, separated by spaces.
+std::string to_uci(const PgnGame& game) {
+  std::string uci;
+  for (const Move& move : game.moves) uci += (uci.empty() ? "" : " ") + move.to_uci();
+  return uci;
+}
+
+std::optional<std::string> san_to_uci(std::string_view san_move, std::string_view fen) {
+  const std::optional<Move> move{san::move(san_move, Board::from_fen(fen))};
+  if (!move) return std::nullopt;
+  return move->to_uci();
+}
+
+constexpr std::string_view games{
+    "[Event \"First\"]\n"
+    "[White \"A \\\"quoted\\\" name\"]\n"
+    "[Result \"1-0\"]\n"
+    "\n"
+    "1. e4 {A comment (with parentheses)} e5 2.Nf3 $1 (2. Bc4 {Bishop's opening} (2. Nc3)) 2... Nc6!? ; Line comment\n"
+    "3. Bb5 a6 1-0\n"
+    "\n"
+    "[Event \"Second\"]\n"
+    "[SetUp \"1\"]\n"
+    "[FEN \"4k3/P7/8/8/8/8/8/4K2R w K - 0 1\"]\n"
+    "\n"
+    "1. O-O Kd7 2. a8=N 1/2-1/2\n"
+    "\n"
+    "[Event \"Third\"]\n"
+    "\n"
+    "1. d4 d5 *\n"};
+}  // namespace
+
+TEST_SUITE("pgn reader") {
+  TEST_CASE("standard algebraic notation") {
+    const std::string_view initial{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"};
+    REQUIRE(san_to_uci("e4", initial) == "e2e4");
+    REQUIRE(san_to_uci("Nf3+", initial) == "g1f3");
+    REQUIRE_FALSE(san_to_uci("e5", initial).has_value());
+    REQUIRE_FALSE(san_to_uci("Bb5", initial).has_value());
+    REQUIRE_FALSE(san_to_uci("xyz", initial).has_value());
+
+    // Both knights can move to d2, so the moving knight must be disambiguated.
+    const std::string_view knights{"4k3/8/8/8/8/8/8/1N2KN2 w - - 0 1"};
+    REQUIRE_FALSE(san_to_uci("Nd2", knights).has_value());
+    REQUIRE(san_to_uci("Nbd2", knights) == "b1d2");
+    REQUIRE(san_to_uci("Nfd2", knights) == "f1d2");
+    const std::string_view rooks{"4k3/R7/8/8/8/8/8/R3K3 w - - 0 1"};
+    REQUIRE(san_to_uci("R1a4", rooks) == "a1a4");
+    REQUIRE(san_to_uci("R7xa4", rooks) == "a7a4");
+
+    const std::string_view pawns{"1n2k3/P7/8/3pP3/8/8/8/4K2R w K d6 0 1"};
+    REQUIRE(san_to_uci("exd6", pawns) == "e5d6");
+    REQUIRE(san_to_uci("axb8=Q#", pawns) == "a7b8q");
+    REQUIRE(san_to_uci("a8R", pawns) == "a7a8r");
+    REQUIRE_FALSE(san_to_uci("a8", pawns).has_value());
+    REQUIRE(san_to_uci("O-O", pawns) == "e1g1");
+    REQUIRE(san_to_uci("0-0", pawns) == "e1g1");
+    REQUIRE_FALSE(san_to_uci("O-O-O", pawns).has_value());
+  }
+
+  TEST_CASE("games") {
+    const auto path{write_pgn(games)};
+    PgnReader reader{path};
+
+    const auto first{reader.next()};
+    REQUIRE(first.has_value());
+    REQUIRE(first->get_tag("Event") == "First");
+    REQUIRE(first->get_tag("White") == "A \\\"quoted\\\" name");
+    REQUIRE_FALSE(first->get_tag("Black").has_value());
+    REQUIRE(first->board == Board::initial());
+    REQUIRE(to_uci(*first) == "e2e4 e7e5 g1f3 b8c6 f1b5 a7a6");
+    REQUIRE(first->result == "1-0");
+
+    const auto second{reader.next()};
+    REQUIRE(second.has_value());
+    REQUIRE(second->board == Board::from_fen("4k3/P7/8/8/8/8/8/4K2R w K - 0 1"));
+    REQUIRE(to_uci(*second) == "e1g1 e8d7 a7a8n");
+    REQUIRE(second->result == "1/2-1/2");
+
+    const auto third{reader.next()};
+    REQUIRE(third.has_value());
+    REQUIRE(third->get_tag("Event") == "Third");
+    REQUIRE(to_uci(*third) == "d2d4 d7d5");
+    REQUIRE(third->result == "*");
+    REQUIRE_FALSE(reader.next().has_value());
+
+    // Moves past the limit are skipped.
+    PgnReader limited_reader{path, 3};
+    REQUIRE(to_uci(limited_reader.next().value()) == "e2e4 e7e5 g1f3");
+    std::filesystem::remove(path);
+  }
+
+  TEST_CASE("byte ranges") {
+    const auto path{write_pgn(games)};
+    // However the file is split, each game is read by exactly one of the readers.
+    for (size_t split{0}; split <= games.size(); split++) {
+      std::string events;
+      PgnReader first_reader{path, 0, split};
+      while (const auto game{first_reader.next()}) events += game->get_tag("Event").value();
+      PgnReader second_reader{path, split, games.size()};
+      while (const auto game{second_reader.next()}) events += game->get_tag("Event").value();
+      REQUIRE(events == "FirstSecondThird");
+    }
+    std::filesystem::remove(path);
+  }
+
+  TEST_CASE("invalid games") {
+    const auto path{write_pgn(
+        "[Event \"First\"]\n"
+        "\n"
+        "1. e4 e4 2. d4 1-0\n"
+        "\n"
+        "[Event \"Second\"]\n"
+        "[FEN \"invalid\"]\n"
+        "\n"
+        "1. e4 *\n"
+        "\n"
+        "[Event \"Third\"]\n"
+        "\n"
+        "1. e4 *\n")};
+    PgnReader reader{path};
+    std::string message;
+    try {
+      reader.next();
+    } catch (const std::runtime_error& error) {
+      message = error.what();
+    }
+    REQUIRE(message.ends_with(":3: invalid move e4"));
+    // Reading continues from the game after an invalid one.
+    REQUIRE_THROWS_AS(reader.next(), std::runtime_error);
+    REQUIRE(reader.next().value().get_tag("Event") == "Third");
+    REQUIRE_FALSE(reader.next().has_value());
+    std::filesystem::remove(path);
+  }
+}
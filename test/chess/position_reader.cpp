@@ -0,0 +1,52 @@
+#include "chess/position_reader.h"
+
+#include <doctest/doctest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+
+using namespace chess;
+
+TEST_SUITE("position_reader") {
+  // Writes `contents` to a temporary file and returns its path.
+  std::filesystem::path write_file(std::string_view name, std::string_view contents) {
+    const auto path{std::filesystem::temp_directory_path() / name};
+    std::ofstream{path} << contents;
+    return path;
+  }
+
+  TEST_CASE("epd") {
+    const auto path{write_file("chess_position_reader_test.epd",
+                               "# Comment\n"
+                               "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - bm e4; id \"initial\";\n"
+                               "\n"
+                               "rnbqkb1r/ppp1pppp/5n2/3pP3/8/8/PPPP1PPP/RNBQKBNR w - d6\r\n")};
+    EpdReader reader{path};
+    const auto first{reader.next()};
+    REQUIRE(first.has_value());
+    REQUIRE(first->board == Board::initial());
+    REQUIRE(first->operations == "bm e4; id \"initial\";");
+    const auto second{reader.next()};
+    REQUIRE(second.has_value());
+    REQUIRE(second->board.get_en_passant() == Bitboard::D6);
+    REQUIRE(second->operations.empty());
+    REQUIRE(!reader.next().has_value());
+    std::filesystem::remove(path);
+  }
+
+  TEST_CASE("csv") {
+    const auto path{write_file("chess_position_reader_test.csv",
+                               "PuzzleId,FEN,Moves\n"
+                               "00001,rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1,e2e4\n"
+                               "00002,rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP w KQkq - 0 1,e2e4\n")};
+    CsvPositionReader reader{path, 1};
+    const auto first{reader.next()};
+    REQUIRE(first.has_value());
+    REQUIRE(first->board == Board::initial());
+    REQUIRE(first->line.starts_with("00001,"));
+    REQUIRE_THROWS_AS(reader.next(), std::runtime_error);
+    std::filesystem::remove(path);
+  }
+}
@@ -0,0 +1,40 @@
+#include "chess/slider_backend.h"
+
+#include <doctest/doctest.h>
+
+#include <random>
+
+#include "chess/bitboard.h"
+#include "chess/pieces/bishop.h"
+#include "chess/pieces/queen.h"
+#include "chess/pieces/rook.h"
+
+using namespace chess;
+
+TEST_SUITE("slider_backend") {
+  TEST_CASE("magic backend is always supported") { REQUIRE(slider_backend::is_supported(SliderBackend::Magic)); }
+
+  TEST_CASE("backends compute the same attacks") {
+    if (!slider_backend::is_supported(SliderBackend::Pext)) return;
+    const SliderBackend original_backend{slider_backend::get()};
+
+    std::mt19937_64 rng{0};
+    for (int index{0}; index < 64; index++) {
+      const Bitboard square{Bitboard::from_index(index)};
+      for (int i{0}; i < 100; i++) {
+        // AND-ing random numbers gives sparser occupancies, which are closer to those of real positions.
+        const Bitboard occupancy{rng() & rng()};
+        slider_backend::set(SliderBackend::Magic);
+        const Bitboard magic_rook{Rook::attacks(square, occupancy)};
+        const Bitboard magic_bishop{Bishop::attacks(square, occupancy)};
+        const Bitboard magic_queen{Queen::attacks(square, occupancy)};
+        slider_backend::set(SliderBackend::Pext);
+        REQUIRE(Rook::attacks(square, occupancy) == magic_rook);
+        REQUIRE(Bishop::attacks(square, occupancy) == magic_bishop);
+        REQUIRE(Queen::attacks(square, occupancy) == magic_queen);
+      }
+    }
+
+    slider_backend::set(original_backend);
+  }
+}
@@ -0,0 +1,174 @@
+#include "chess/tablebase.h"
+
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "chess/board.h"
+#include "chess/kpk.h"
+#include "chess/move_gen.h"
+#include "chess/tablebase_generator.h"
+
+using namespace chess;
+
+namespace {
+// Generates the tablebases of all materials with 3 pieces where white has the piece into a temporary directory (the
+// first time it is called), and returns them.
+const Tablebases& generate_tablebases() {
+  static const Tablebases tablebases{[]() {
+    const std::filesystem::path directory{std::filesystem::temp_directory_path() / "chess_tablebase_test"};
+    std::filesystem::create_directories(directory);
+    Tablebases generated;
+    for (const std::string_view material_string : {"KQvK", "KRvK", "KBvK", "KNvK", "KPvK"}) {
+      const Material material{Material::from_string(material_string).value()};
+      const std::filesystem::path path{directory / (material.to_string() + std::string{Tablebases::extension})};
+      const tablebase_generator::Stats stats{tablebase_generator::generate(material, generated, path, 2)};
+      if (material_string == "KQvK") REQUIRE(stats.max_plies_to_mate == 20);
+      if (material_string == "KRvK") REQUIRE(stats.max_plies_to_mate == 32);
+      if (material_string == "KBvK" || material_string == "KNvK") REQUIRE(stats.wins + stats.losses == 0);
+      generated.add(Tablebase{path});
+    }
+    return generated;
+  }()};
+  return tablebases;
+}
+
+// Returns the board with white's king, black's king and the piece on the given squares, or std::nullopt if it is not
+// legal.
+std::optional<Board> make_board(int white_king, int black_king, Color piece_color, PieceType piece, int piece_square,
+                                bool is_white_turn) {
+  if (white_king == black_king || white_king == piece_square || black_king == piece_square) return std::nullopt;
+  const Bitboard piece_bit{Bitboard::from_index(piece_square)};
+  if (piece == PieceType::Pawn && (piece_bit & (Bitboard::rank_1 | Bitboard::rank_8))) return std::nullopt;
+  Player white{Player::empty()};
+  Player black{Player::empty()};
+  white[PieceType::King] = Bitboard::from_index(white_king);
+  black[PieceType::King] = Bitboard::from_index(black_king);
+  (piece_color == Color::White ? white : black)[piece] = piece_bit;
+  const Board board{white, black, Bitboard::empty, is_white_turn};
+  if (board.skip_turn().is_in_check()) return std::nullopt;
+  return board;
+}
+
+// Checks that the result of the board is consistent with the results after each of its moves.
+void check_consistency(const Tablebases& tablebases, const Board& board) {
+  const TablebaseResult result{tablebases.probe(board).value()};
+  MoveContainer moves{move_gen::generate_moves(board)};
+  if (moves.empty()) {
+    REQUIRE(result.wdl == (board.is_in_check() ? Wdl::Loss : Wdl::Draw));
+    REQUIRE(result.plies_to_mate == 0);
+    return;
+  }
+
+  int min_win{1000};
+  int max_loss{0};
+  bool has_draw{false};
+  for (const Move& move : moves) {
+    const TablebaseResult next_result{tablebases.probe(board.apply_move(move)).value()};
+    if (next_result.wdl == Wdl::Loss) min_win = std::min(min_win, next_result.plies_to_mate + 1);
+    if (next_result.wdl == Wdl::Win) max_loss = std::max(max_loss, next_result.plies_to_mate + 1);
+    if (next_result.wdl == Wdl::Draw) has_draw = true;
+  }
+  if (min_win < 1000) {
+    REQUIRE(result.wdl == Wdl::Win);
+    REQUIRE(result.plies_to_mate == min_win);
+  } else if (has_draw) {
+    REQUIRE(result.wdl == Wdl::Draw);
+  } else {
+    REQUIRE(result.wdl == Wdl::Loss);
+    REQUIRE(result.plies_to_mate == max_loss);
+  }
+}
+}  // namespace
+
+TEST_SUITE("tablebase") {
+  TEST_CASE("material") {
+    const Material material{Material::from_string("KRPvKR").value()};
+    REQUIRE(material.to_string() == "KRPvKR");
+    REQUIRE(material.count() == 5);
+    REQUIRE(material.count(Color::White, PieceType::Rook) == 1);
+    REQUIRE(material.count(Color::Black, PieceType::Pawn) == 0);
+    REQUIRE(material.flip().to_string() == "KRvKRP");
+    REQUIRE(Material::from_string("KPRvKR").value() == material);
+    REQUIRE(Material::of(Board::from_fen("8/8/8/3k4/8/2r5/2KRP3/8 w - - 0 1")) == material);
+
+    REQUIRE_FALSE(Material::from_string("KQK").has_value());
+    REQUIRE_FALSE(Material::from_string("KQvQ").has_value());
+    REQUIRE_FALSE(Material::from_string("KXvK").has_value());
+  }
+
+  TEST_CASE("sub materials") {
+    const auto sub_materials{tablebase_generator::get_sub_materials(Material::from_string("KPvKN").value())};
+    std::vector<std::string> strings;
+    for (const Material& material : sub_materials) strings.push_back(material.to_string());
+    std::sort(strings.begin(), strings.end());
+    // Captures of either player's piece, and promotions (which may also capture).
+    REQUIRE(strings == std::vector<std::string>{"KBvK", "KBvKN", "KNvK", "KNvKN", "KPvK", "KQvK", "KQvKN", "KRvK",
+                                                "KRvKN", "KvKN"});
+  }
+
+  TEST_CASE("known results") {
+    const Tablebases& tablebases{generate_tablebases()};
+    REQUIRE(tablebases.get_max_piece_count() == 3);
+    REQUIRE_FALSE(tablebases.probe(Board::initial()).has_value());
+
+    // Kings only.
+    REQUIRE(tablebases.probe(Board::from_fen("8/8/8/3k4/8/8/2K5/8 w - - 0 1")).value().wdl == Wdl::Draw);
+    // Mate in one.
+    const TablebaseResult mate_in_one{tablebases.probe(Board::from_fen("k7/8/1K6/8/8/8/7Q/8 w - - 0 1")).value()};
+    REQUIRE(mate_in_one.wdl == Wdl::Win);
+    REQUIRE(mate_in_one.plies_to_mate == 1);
+    // Checkmated.
+    const TablebaseResult mated{tablebases.probe(Board::from_fen("k6R/8/1K6/8/8/8/8/8 b - - 0 1")).value()};
+    REQUIRE(mated.wdl == Wdl::Loss);
+    REQUIRE(mated.plies_to_mate == 0);
+    // The queen is captured.
+    REQUIRE(tablebases.probe(Board::from_fen("8/8/8/8/8/5k2/7q/7K w - - 0 1")).value().wdl == Wdl::Draw);
+    // Tablebases do not account for castling.
+    REQUIRE(tablebases.probe(Board::from_fen("4k3/8/8/8/8/8/8/R3K3 w - - 0 1")).has_value());
+    REQUIRE_FALSE(tablebases.probe(Board::from_fen("4k3/8/8/8/8/8/8/R3K3 w Q - 0 1")).has_value());
+    // En passant squares that no pawn can capture on are ignored.
+    REQUIRE(tablebases.probe(Board::from_fen("8/8/8/8/3P4/8/8/K6k b - d3 0 1")).has_value());
+    // Tablebases are probed with the colors of the players in either order.
+    const TablebaseResult flipped{tablebases.probe(Board::from_fen("8/7q/8/8/8/1k6/8/K7 b - - 0 1")).value()};
+    REQUIRE(flipped.wdl == Wdl::Win);
+    REQUIRE(flipped.plies_to_mate == 1);
+  }
+
+  TEST_CASE("consistent with moves") {
+    const Tablebases& tablebases{generate_tablebases()};
+    for (const PieceType piece : {PieceType::Queen, PieceType::Rook, PieceType::Pawn}) {
+      for (int white_king{0}; white_king < 64; white_king++) {
+        for (int black_king{0}; black_king < 64; black_king += 3) {
+          for (int piece_square{0}; piece_square < 64; piece_square += 5) {
+            for (const bool is_white_turn : {true, false}) {
+              const auto board{make_board(white_king, black_king, Color::White, piece, piece_square, is_white_turn)};
+              if (board) check_consistency(tablebases, *board);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  TEST_CASE("king and pawn vs king matches kpk") {
+    const Tablebases& tablebases{generate_tablebases()};
+    for (int white_king{0}; white_king < 64; white_king++) {
+      for (int black_king{0}; black_king < 64; black_king++) {
+        for (int pawn{8}; pawn < 56; pawn++) {
+          for (const bool is_white_turn : {true, false}) {
+            const auto board{make_board(white_king, black_king, Color::Black, PieceType::Pawn, pawn, is_white_turn)};
+            if (!board) continue;
+            const bool is_win{tablebases.probe(*board).value().wdl != Wdl::Draw};
+            REQUIRE(is_win == kpk::probe(*board).value());
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+#include "chess/board.h"
+#include "chess/move.h"
+
+namespace chess_test {
+
+// Positions from https://www.chessprogramming.org/Perft_Results, which between them have castling, en passant and
+// promotions within a few plies.
+namespace perft_positions {
+constexpr std::string_view position_2{"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 0"};
+constexpr std::string_view position_3{"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 0"};
+constexpr std::string_view position_4{"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1"};
+constexpr std::string_view position_5{"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"};
+}  // namespace perft_positions
+
+// Calls `visit(board, move)` for every legal move of `board`, and of every board reachable from it within `depth - 1`
+// plies.
+template <typename Visitor>
+void for_each_move(const chess::Board& board, size_t depth, Visitor&& visit) {
+  if (depth == 0) return;
+  for (const chess::Move& move : board.generate_moves()) {
+    visit(board, move);
+    for_each_move(board.apply_move(move), depth - 1, visit);
+  }
+}
+
+}  // namespace chess_test